@@ -1,4 +1,5 @@
 #include <SIM7600HTTPS.h>  // Library for HTTP GET and POST with SIM7600 module
+#include <SIM7600Scheduler.h>  // Priority/deadline scheduler for sharing the modem
 #define SerialAT Serial1        // Serial port for SIM7600 communication (Serial1 for Arduino Mega)
 const char* apn = "saf";  // APN for GPRS connection (e.g., "safaricom" for Safaricom network)
 
@@ -7,9 +8,11 @@ const char* resourceGet = "/api/get";
 const char* resourcePost = "/api/post";
                                                                          // POST endpoint to submit data
 const char* postData = "{\"title\":\"Generic Test Post\",\"body\":\"This is a generic post for testing API endpoints.\",\"userId\":1}";  // Generic JSON data for POST
-unsigned long previousMillis = 0;                                                                                                        // Tracks last request time
-const long interval = 10000;                                                                                                             // Interval for HTTP requests (10 seconds)
 SIM7600HTTPS modem;                                                                                                                      // SIM7600HTTPS object for HTTP operations
+SIM7600Scheduler scheduler;                                                                                                              // Shares the modem between GET and POST jobs
+bool getJob(void* ctx);
+bool postJob(void* ctx);
+void onMiss(int id, unsigned long latenessMs);
 
 void setup() {
   Serial.begin(115200);    // Initialize serial for debugging
@@ -21,40 +24,38 @@ void setup() {
     if (modem.gprsConnect(apn)) {
       modem.httpInit(server, "");  // Dummy init to prime module (no URL set) Empty resource skips URL
       Serial.println("SUCCESS");   // GPRS connection established
+      scheduler.setMissCallback(onMiss);
+      scheduler.addPeriodic(getJob, nullptr, 2000, 1, 2000, 100, SIM7600_JOB_DROP_STALE);  // GET every 2 s, 100 ms jitter
+      scheduler.addPeriodic(postJob, nullptr, 10000, 2, 5000);                             // POST every 10 s, 5 s deadline
     } else {
       Serial.println("GPRS connection failed");  // GPRS connection error
     }
   }
 }
 
-void loop() {
-  unsigned long currentMillis = millis();  // Current time for timing logic
-
-  // GET request every 2 seconds
-  static unsigned long previousMillisGet = 0;
-  const long getInterval = 2000;  // 2 seconds
-  if (currentMillis - previousMillisGet >= getInterval) {
-    previousMillisGet = currentMillis;  // Update last GET time
+// GET job: routine poll, stale instances are dropped rather than sent late
+bool getJob(void* ctx) {
+  if (!modem.httpInit(server, resourceGet)) return false;  // Initialize HTTP session for GET
+  String serverResponse;
+  if (!modem.httpGet(serverResponse)) return false;  // Execute GET request
+  Serial.println("GET Response: " + serverResponse);  // Print server response
+  return true;
+}
 
-    if (modem.httpInit(server, resourceGet)) {  // Initialize HTTP session for GET
-      String serverResponse;
-      if (modem.httpGet(serverResponse)) {                  // Execute GET request
-        Serial.println("GET Response: " + serverResponse);  // Print server response
-      }
-    }
-  }
+// POST job: higher priority so it goes ahead of queued GETs
+bool postJob(void* ctx) {
+  if (!modem.httpInit(server, resourcePost, 1)) return false;  // Initialize HTTP session for POST
+  String serverResponse;
+  if (!modem.httpPost(postData, serverResponse)) return false;  // Execute POST request with JSON data
+  Serial.println("POST Response: " + serverResponse);  // Print server response
+  return true;
+}
 
-  // POST request every 10 seconds
-  static unsigned long previousMillisPost = 0;
-  const long postInterval = 10000;  // 10 seconds
-  if (currentMillis - previousMillisPost >= postInterval) {
-    previousMillisPost = currentMillis;  // Update last POST time
+// Report deadline misses
+void onMiss(int id, unsigned long latenessMs) {
+  Serial.println("Deadline missed by job " + String(id) + " (" + String(latenessMs) + " ms late)");
+}
 
-    if (modem.httpInit(server, resourcePost, 1)) {  // Initialize HTTP session for POST
-      String serverResponse;
-      if (modem.httpPost(postData, serverResponse)) {        // Execute POST request with JSON data
-        Serial.println("POST Response: " + serverResponse);  // Print server response
-      }
-    }
-  }
-}
\ No newline at end of file
+void loop() {
+  scheduler.run();  // Runs the most urgent due request, one per call
+}
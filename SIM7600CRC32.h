@@ -0,0 +1,21 @@
+#ifndef SIM7600CRC32_H  // Prevent multiple inclusions
+#define SIM7600CRC32_H
+
+#include <Arduino.h>
+// Notes:
+// - Streaming CRC-32 (IEEE 802.3, same as zip/gzip), fed chunk by chunk.
+// - Uses a 16-entry nibble table to keep flash/RAM use small on AVR.
+
+class SIM7600CRC32 {
+public:
+  SIM7600CRC32() { reset(); }
+  void reset() { crc = 0xFFFFFFFFUL; }
+  void resume(uint32_t value) { crc = value ^ 0xFFFFFFFFUL; }  // Continue after data whose CRC-32 is value
+  void update(const uint8_t* data, size_t len);
+  uint32_t value() const { return crc ^ 0xFFFFFFFFUL; }
+
+private:
+  uint32_t crc;
+};
+
+#endif  // End of include guard
@@ -0,0 +1,4 @@
+#include "SIM7600Clock.h"
+
+// Default clock backed by the Arduino core
+SIM7600Clock SIM7600SystemClock;
@@ -0,0 +1,20 @@
+#ifndef SIM7600CLOCK_H  // Prevent multiple inclusions
+#define SIM7600CLOCK_H
+
+#include <Arduino.h>
+// Notes:
+// - Time source used by SIM7600HTTPS and SIM7600Scheduler instead of the global millis()/delay().
+// - Subclass it to drive the library from a simulated or shared clock.
+
+class SIM7600Clock {
+public:
+  virtual ~SIM7600Clock() {}
+  virtual unsigned long millis() { return ::millis(); }
+  virtual unsigned long micros() { return ::micros(); }
+  virtual void delay(unsigned long ms) { ::delay(ms); }
+};
+
+// Default clock backed by the Arduino core
+extern SIM7600Clock SIM7600SystemClock;
+
+#endif  // End of include guard
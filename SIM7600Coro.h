@@ -0,0 +1,176 @@
+#ifndef SIM7600CORO_H  // Prevent multiple inclusions
+#define SIM7600CORO_H
+
+#include "SIM7600HTTPS.h"
+// Notes:
+// - Optional C++20 coroutine front-end (co_await modem.get(...)). Compiles to nothing without
+//   coroutine support (e.g. AVR), so including it is always safe.
+// - Tasks are stackless: each one costs only its heap-allocated coroutine frame.
+// - Everything runs on one thread: call executor.poll() from loop().
+// - Requests share the modem in FIFO order; the wait for +HTTPACTION never blocks.
+// - Not everything is non-blocking: the first poll of a request runs httpInit() (TERM/INIT/PARA)
+//   and beginHttpAction() (USERDATA, HTTPDATA upload for POST) in one go, and every body poll
+//   runs one HTTPREAD chunk. These are module-local exchanges, normally tens of ms, but each
+//   can wait up to its timeout when the module does not answer. A gzip response is inflated
+//   whole in the last body poll, not chunk by chunk.
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define SIM7600_HAS_COROUTINES 1
+#include <coroutine>
+
+// Fire-and-forget coroutine: starts immediately, frame freed when it returns
+struct SIM7600Task {
+  struct promise_type {
+    SIM7600Task get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() {}
+  };
+};
+
+// A suspended task and the condition it waits for
+struct SIM7600Waiter {
+  virtual bool ready() = 0;  // Polled by the executor; may advance modem I/O
+  std::coroutine_handle<> handle;
+  SIM7600Waiter* next = nullptr;
+};
+
+// Single-threaded executor: resumes parked tasks whose condition is ready
+class SIM7600Executor {
+public:
+  SIM7600Executor(SIM7600Clock& clk = SIM7600SystemClock) : clock(&clk) {}
+
+  // Queue a waiter behind the existing ones (FIFO keeps modem access fair)
+  void park(SIM7600Waiter* waiter) {
+    waiter->next = nullptr;
+    SIM7600Waiter** link = &head;
+    while (*link) link = &(*link)->next;
+    *link = waiter;
+  }
+
+  // One pass over the parked tasks, returns true while any task is still waiting
+  bool poll() {
+    SIM7600Waiter** link = &head;
+    while (*link) {
+      SIM7600Waiter* waiter = *link;
+      if (waiter->ready()) {
+        *link = waiter->next;     // Unlink first: the waiter lives in the frame being resumed
+        waiter->handle.resume();
+      } else {
+        link = &waiter->next;
+      }
+    }
+    return head != nullptr;
+  }
+
+  bool idle() const { return head == nullptr; }
+  SIM7600Clock& time() { return *clock; }
+
+private:
+  SIM7600Waiter* head = nullptr;
+  SIM7600Clock* clock;
+};
+
+// Common awaiter plumbing: check once if nobody is queued, otherwise park with the executor.
+// A new await never checks ahead of parked waiters, so it cannot take the modem before them.
+template <class Op>
+struct SIM7600Awaitable : SIM7600Waiter {
+  SIM7600Executor* exec;
+  explicit SIM7600Awaitable(SIM7600Executor& e) : exec(&e) {}
+  bool await_ready() { return exec->idle() && static_cast<Op*>(this)->ready(); }
+  void await_suspend(std::coroutine_handle<> h) { handle = h; exec->park(this); }
+};
+
+// Result of co_await get()/post()
+struct SIM7600CoResult {
+  bool ok = false;
+  int status = 0;   // HTTP status code
+  String body;
+};
+
+// Coroutine view of one modem
+class SIM7600CoModem {
+public:
+  SIM7600CoModem(SIM7600HTTPS& m, SIM7600Executor& e) : modem(&m), exec(&e) {}
+
+  // HTTP request: waits for the modem, sets it up and uploads the body (blocking), then polls
+  // for the server's answer without blocking and reads the body one chunk per poll
+  struct HttpOp : SIM7600Awaitable<HttpOp> {
+    SIM7600CoModem* co;
+    const char* server;
+    const char* resource;
+    int method;
+    const char* data;
+    bool started = false;
+    SIM7600CoResult result;
+
+    HttpOp(SIM7600CoModem* c, const char* s, const char* r, int m, const char* d)
+        : SIM7600Awaitable<HttpOp>(*c->exec), co(c), server(s), resource(r), method(m), data(d) {}
+
+    bool ready() override {
+      SIM7600HTTPS& modem = *co->modem;
+      if (!started) {
+        if (co->owner != nullptr) return false;  // Modem busy with another task
+        co->owner = this;
+        started = true;
+        if (!modem.httpInit(server, resource, method) || !modem.beginHttpAction(method, data)) {
+          co->owner = nullptr;
+          return true;  // result.ok stays false
+        }
+        return false;
+      }
+      int state = modem.pollHttp();
+      if (state == SIM7600_PENDING) return false;
+      result.ok = (state == SIM7600_DONE);
+      result.status = modem.lastStatus();
+      if (result.ok) result.body = modem.takeHttpResponse();
+      co->owner = nullptr;
+      return true;
+    }
+    SIM7600CoResult await_resume() { return result; }
+  };
+
+  // GPRS bring-up: waits for the modem, then runs the (short, blocking) AT sequence
+  struct ConnectOp : SIM7600Awaitable<ConnectOp> {
+    SIM7600CoModem* co;
+    const char* apn;
+    bool ok = false;
+
+    ConnectOp(SIM7600CoModem* c, const char* a) : SIM7600Awaitable<ConnectOp>(*c->exec), co(c), apn(a) {}
+
+    bool ready() override {
+      if (co->owner != nullptr) return false;
+      ok = co->modem->gprsConnect(apn);
+      return true;
+    }
+    bool await_resume() { return ok; }
+  };
+
+  // Non-blocking replacement for delay()
+  struct SleepOp : SIM7600Awaitable<SleepOp> {
+    unsigned long start;
+    unsigned long ms;
+
+    SleepOp(SIM7600Executor& e, unsigned long d) : SIM7600Awaitable<SleepOp>(e), start(e.time().millis()), ms(d) {}
+
+    bool ready() override { return exec->time().millis() - start >= ms; }
+    void await_resume() {}
+  };
+
+  HttpOp get(const char* server, const char* resource) { return HttpOp(this, server, resource, 0, nullptr); }
+  HttpOp post(const char* server, const char* resource, const char* data) { return HttpOp(this, server, resource, 1, data); }
+  ConnectOp connect(const char* apn) { return ConnectOp(this, apn); }
+  SleepOp sleep(unsigned long ms) { return SleepOp(*exec, ms); }
+
+private:
+  SIM7600HTTPS* modem;
+  SIM7600Executor* exec;
+  const void* owner = nullptr;  // Operation currently using the modem
+};
+
+#endif  // __has_include(<coroutine>)
+#endif  // __cpp_impl_coroutine
+
+#endif  // End of include guard
@@ -0,0 +1,457 @@
+#include "SIM7600Deflate.h"
+
+// Length codes 257..285: base length and extra bits
+static const uint16_t lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+// Distance codes 0..29: base distance and extra bits
+static const uint16_t distBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                      257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t distExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                      7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// ---------------------------------------------------------------------------
+// Compressor
+// ---------------------------------------------------------------------------
+
+// LSB-first bit writer on top of a Print
+struct DeflateBitWriter
+{
+  Print &out;
+  uint32_t buf;
+  uint8_t count;
+  size_t written;
+
+  DeflateBitWriter(Print &p) : out(p), buf(0), count(0), written(0) {}
+
+  void bits(uint32_t value, uint8_t n)
+  {
+    buf |= value << count;
+    count += n;
+    while (count >= 8)
+    {
+      out.write((uint8_t)buf);
+      written++;
+      buf >>= 8;
+      count -= 8;
+    }
+  }
+
+  // Huffman codes are defined MSB-first
+  void code(uint16_t value, uint8_t n)
+  {
+    uint16_t reversed = 0;
+    for (uint8_t i = 0; i < n; i++)
+    {
+      reversed = (reversed << 1) | ((value >> i) & 1);
+    }
+    bits(reversed, n);
+  }
+
+  void literal(uint16_t symbol)
+  {
+    if (symbol < 144)
+      code(0x30 + symbol, 8);
+    else if (symbol < 256)
+      code(0x190 + symbol - 144, 9);
+    else if (symbol < 280)
+      code(symbol - 256, 7);
+    else
+      code(0xC0 + symbol - 280, 8);
+  }
+
+  void match(uint16_t length, uint16_t distance)
+  {
+    uint8_t i = 28;
+    while (lengthBase[i] > length)
+      i--;
+    literal(257 + i);
+    bits(length - lengthBase[i], lengthExtra[i]);
+
+    uint8_t d = 29;
+    while (distBase[d] > distance)
+      d--;
+    code(d, 5);
+    bits(distance - distBase[d], distExtra[d]);
+  }
+
+  void flush()
+  {
+    if (count > 0)
+    {
+      out.write((uint8_t)buf);
+      written++;
+    }
+    buf = 0;
+    count = 0;
+  }
+};
+
+static uint8_t hash3(const uint8_t *p)
+{
+  return ((p[0] << 5) ^ (p[1] << 3) ^ p[2]) & 0xFF;
+}
+
+static void writeLE32(Print &out, uint32_t value)
+{
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    out.write((uint8_t)(value >> (8 * i)));
+  }
+}
+
+// Public: gzip-compress a buffer into out
+size_t SIM7600Deflate::gzip(const uint8_t *in, size_t len, Print &out)
+{
+  // gzip header: magic, deflate, no flags, no mtime, no extra flags, OS unknown
+  static const uint8_t header[10] = {0x1F, 0x8B, 0x08, 0x00, 0, 0, 0, 0, 0x00, 0xFF};
+  out.write(header, sizeof(header));
+
+  DeflateBitWriter writer(out);
+  writer.bits(1, 1); // BFINAL
+  writer.bits(1, 2); // BTYPE = fixed Huffman
+
+  // Positions are stored modulo 65536; every candidate is verified byte by byte
+  uint16_t head[256];
+  memset(head, 0, sizeof(head));
+
+  size_t pos = 0;
+  while (pos < len)
+  {
+    if (pos + 3 <= len)
+    {
+      uint8_t h = hash3(in + pos);
+      size_t distance = (uint16_t)(pos - head[h]);
+      head[h] = (uint16_t)pos;
+
+      if (distance > 0 && distance <= SIM7600_DEFLATE_WINDOW && distance <= pos)
+      {
+        const uint8_t *candidate = in + pos - distance;
+        size_t length = 0;
+        while (length < 258 && pos + length < len && candidate[length] == in[pos + length])
+          length++;
+
+        if (length >= 3)
+        {
+          writer.match(length, distance);
+          // Index the positions inside the match so later data can refer to them
+          for (size_t i = pos + 1; i < pos + length && i + 3 <= len; i++)
+          {
+            head[hash3(in + i)] = (uint16_t)i;
+          }
+          pos += length;
+          continue;
+        }
+      }
+    }
+    writer.literal(in[pos]);
+    pos++;
+  }
+  writer.literal(256); // End of block
+  writer.flush();
+
+  SIM7600CRC32 crc;
+  crc.update(in, len);
+  writeLE32(out, crc.value());
+  writeLE32(out, (uint32_t)len);
+  return sizeof(header) + writer.written + 8;
+}
+
+// ---------------------------------------------------------------------------
+// Decompressor
+// ---------------------------------------------------------------------------
+
+// Canonical Huffman table: code counts per length and symbols sorted by code
+template <int N>
+struct InflateTree
+{
+  uint16_t counts[16];
+  uint16_t symbols[N];
+};
+
+struct InflateState
+{
+  SIM7600ByteSource source;
+  void *ctx;
+  uint16_t bitbuf;
+  uint8_t bitcount;
+  bool error;
+
+  int byte()
+  {
+    int b = source(ctx);
+    if (b < 0)
+    {
+      error = true; // Input ended early
+      return 0;
+    }
+    return b;
+  }
+
+  unsigned bit()
+  {
+    if (bitcount == 0)
+    {
+      bitbuf = byte();
+      bitcount = 8;
+    }
+    unsigned b = bitbuf & 1;
+    bitbuf >>= 1;
+    bitcount--;
+    return b;
+  }
+
+  unsigned bits(uint8_t n)
+  {
+    unsigned value = 0;
+    for (uint8_t i = 0; i < n; i++)
+    {
+      value |= bit() << i;
+    }
+    return value;
+  }
+
+  template <int N>
+  int decode(const InflateTree<N> &tree)
+  {
+    int sum = 0;
+    int cur = 0;
+    for (uint8_t len = 1; len < 16; len++)
+    {
+      cur = 2 * cur + bit();
+      sum += tree.counts[len];
+      cur -= tree.counts[len];
+      if (cur < 0)
+        return tree.symbols[sum + cur];
+      if (error)
+        return -1;
+    }
+    error = true; // No code matched
+    return -1;
+  }
+};
+
+template <int N>
+static void buildTree(InflateTree<N> &tree, const uint8_t *lengths, int num)
+{
+  uint16_t offsets[16];
+  memset(tree.counts, 0, sizeof(tree.counts));
+  for (int i = 0; i < num; i++)
+  {
+    tree.counts[lengths[i]]++;
+  }
+  tree.counts[0] = 0;
+
+  uint16_t sum = 0;
+  for (int i = 0; i < 16; i++)
+  {
+    offsets[i] = sum;
+    sum += tree.counts[i];
+  }
+  for (int i = 0; i < num; i++)
+  {
+    if (lengths[i])
+      tree.symbols[offsets[lengths[i]]++] = i;
+  }
+}
+
+// Private: Read the code length tables of a dynamic block
+static bool readDynamicTrees(InflateState &s, InflateTree<288> &lit, InflateTree<30> &dist)
+{
+  static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+  uint8_t lengths[288 + 32];
+
+  unsigned hlit = s.bits(5) + 257;
+  unsigned hdist = s.bits(5) + 1;
+  unsigned hclen = s.bits(4) + 4;
+  if (hlit > 286 || hdist > 30)
+    return false;
+
+  InflateTree<19> codeTree;
+  memset(lengths, 0, 19);
+  for (unsigned i = 0; i < hclen; i++)
+  {
+    lengths[order[i]] = s.bits(3);
+  }
+  buildTree(codeTree, lengths, 19);
+
+  unsigned n = 0;
+  while (n < hlit + hdist && !s.error)
+  {
+    int sym = s.decode(codeTree);
+    if (sym < 0)
+      return false;
+    if (sym < 16)
+    {
+      lengths[n++] = sym;
+      continue;
+    }
+
+    uint8_t value = 0;
+    unsigned repeat;
+    if (sym == 16)
+    {
+      if (n == 0)
+        return false;
+      value = lengths[n - 1];
+      repeat = 3 + s.bits(2);
+    }
+    else if (sym == 17)
+    {
+      repeat = 3 + s.bits(3);
+    }
+    else
+    {
+      repeat = 11 + s.bits(7);
+    }
+    if (n + repeat > hlit + hdist)
+      return false;
+    while (repeat--)
+      lengths[n++] = value;
+  }
+  if (s.error)
+    return false;
+
+  buildTree(lit, lengths, hlit);
+  buildTree(dist, lengths + hlit, hdist);
+  return true;
+}
+
+// Private: Decode one Huffman-coded block into out
+static bool inflateBlock(InflateState &s, const InflateTree<288> &lit, const InflateTree<30> &dist,
+                         String &out, unsigned int start)
+{
+  for (;;)
+  {
+    int sym = s.decode(lit);
+    if (sym < 0 || s.error)
+      return false;
+    if (sym < 256)
+    {
+      out += (char)sym;
+      continue;
+    }
+    if (sym == 256)
+      return true;
+
+    sym -= 257;
+    if (sym >= 29)
+      return false;
+    unsigned length = lengthBase[sym] + s.bits(lengthExtra[sym]);
+
+    int dsym = s.decode(dist);
+    if (dsym < 0 || dsym >= 30)
+      return false;
+    unsigned distance = distBase[dsym] + s.bits(distExtra[dsym]);
+    if (s.error || distance > out.length() - start)
+      return false;
+
+    // History window is the output itself
+    for (unsigned i = 0; i < length; i++)
+    {
+      out += out[out.length() - distance];
+    }
+  }
+}
+
+// Public: Decode one gzip member
+bool SIM7600Inflate::gunzip(SIM7600ByteSource source, void *ctx, String &out)
+{
+  InflateState s = {source, ctx, 0, 0, false};
+  unsigned int start = out.length();
+
+  // Header
+  if (s.byte() != 0x1F || s.byte() != 0x8B || s.byte() != 0x08)
+    return false;
+  uint8_t flags = s.byte();
+  for (uint8_t i = 0; i < 6; i++)
+    s.byte(); // MTIME, XFL, OS
+  if (flags & 0x04)
+  { // FEXTRA
+    unsigned xlen = s.byte();
+    xlen |= (unsigned)s.byte() << 8;
+    while (xlen-- && !s.error)
+      s.byte();
+  }
+  if (flags & 0x08)
+  { // FNAME
+    while (s.byte() != 0 && !s.error)
+      ;
+  }
+  if (flags & 0x10)
+  { // FCOMMENT
+    while (s.byte() != 0 && !s.error)
+      ;
+  }
+  if (flags & 0x02)
+  { // FHCRC
+    s.byte();
+    s.byte();
+  }
+  if (s.error)
+    return false;
+
+  // Blocks
+  InflateTree<288> lit;
+  InflateTree<30> dist;
+  bool last = false;
+  while (!last)
+  {
+    last = s.bit();
+    unsigned type = s.bits(2);
+    if (s.error)
+      return false;
+
+    if (type == 0)
+    { // Stored: byte-aligned LEN, NLEN, raw data
+      s.bitcount = 0;
+      unsigned len = s.byte();
+      len |= (unsigned)s.byte() << 8;
+      unsigned nlen = s.byte();
+      nlen |= (unsigned)s.byte() << 8;
+      if ((len ^ 0xFFFF) != nlen)
+        return false;
+      while (len-- && !s.error)
+        out += (char)s.byte();
+    }
+    else if (type == 1)
+    { // Fixed Huffman
+      uint8_t lengths[288];
+      memset(lengths, 8, 144);
+      memset(lengths + 144, 9, 112);
+      memset(lengths + 256, 7, 24);
+      memset(lengths + 280, 8, 8);
+      buildTree(lit, lengths, 288);
+      memset(lengths, 5, 30);
+      buildTree(dist, lengths, 30);
+      if (!inflateBlock(s, lit, dist, out, start))
+        return false;
+    }
+    else if (type == 2)
+    { // Dynamic Huffman
+      if (!readDynamicTrees(s, lit, dist) || !inflateBlock(s, lit, dist, out, start))
+        return false;
+    }
+    else
+    {
+      return false;
+    }
+    if (s.error)
+      return false;
+  }
+
+  // Trailer: CRC-32 and size of the uncompressed data
+  uint32_t expectedCrc = 0;
+  uint32_t expectedSize = 0;
+  for (uint8_t i = 0; i < 4; i++)
+    expectedCrc |= (uint32_t)s.byte() << (8 * i);
+  for (uint8_t i = 0; i < 4; i++)
+    expectedSize |= (uint32_t)s.byte() << (8 * i);
+  if (s.error)
+    return false;
+
+  SIM7600CRC32 crc;
+  crc.update((const uint8_t *)out.c_str() + start, out.length() - start);
+  return crc.value() == expectedCrc && (uint32_t)(out.length() - start) == expectedSize;
+}
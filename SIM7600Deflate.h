@@ -0,0 +1,43 @@
+#ifndef SIM7600DEFLATE_H  // Prevent multiple inclusions
+#define SIM7600DEFLATE_H
+
+#include <Arduino.h>
+#include "SIM7600CRC32.h"
+// Notes:
+// - Small-footprint gzip (RFC 1952 / deflate RFC 1951) for HTTP bodies.
+// - Compressor: greedy LZ77 over the in-memory input with a 256-entry hash table (512 B RAM)
+//   and fixed Huffman codes. Output streams straight into a Print, so no compressed copy is kept.
+// - Decompressor: pulls input a byte at a time from a callback, so it can decode HTTPREAD chunks
+//   as they arrive. The output String doubles as the history window (no separate 32 KB buffer).
+
+// Maximum match distance used by the compressor (deflate allows up to 32768)
+#ifndef SIM7600_DEFLATE_WINDOW
+  #define SIM7600_DEFLATE_WINDOW 1024
+#endif
+
+// Byte source for the decompressor: next byte (0-255), or -1 when no more input
+typedef int (*SIM7600ByteSource)(void* ctx);
+
+// Print that only counts bytes (first pass to get the compressed length for AT+HTTPDATA)
+class SIM7600ByteCounter : public Print {
+public:
+  size_t write(uint8_t) override { count++; return 1; }
+  size_t write(const uint8_t*, size_t len) override { count += len; return len; }
+  size_t count = 0;
+};
+
+class SIM7600Deflate {
+public:
+  // Compress in[0..len) as a gzip member into out, returns bytes written
+  static size_t gzip(const uint8_t* in, size_t len, Print& out);
+};
+
+class SIM7600Inflate {
+public:
+  // Decode one gzip member pulled from source, appending to out. Returns false on corrupt data or CRC mismatch.
+  static bool gunzip(SIM7600ByteSource source, void* ctx, String& out);
+  // True if the bytes start with the gzip magic number
+  static bool isGzip(const uint8_t* data, size_t len) { return len >= 2 && data[0] == 0x1F && data[1] == 0x8B; }
+};
+
+#endif  // End of include guard
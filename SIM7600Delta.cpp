@@ -0,0 +1,218 @@
+#include "SIM7600Delta.h"
+#include <math.h>
+
+// Constructor
+SIM7600DeltaEncoder::SIM7600DeltaEncoder(const char *streamId, SIM7600Clock &clk) : stream(streamId), clock(&clk)
+{
+}
+
+// Private: FNV-1a hash of a value's JSON text (never 0, which marks an absent field)
+uint32_t SIM7600DeltaEncoder::hashValue(const String &json)
+{
+  uint32_t hash = 2166136261UL;
+  for (unsigned int i = 0; i < json.length(); i++)
+  {
+    hash ^= (uint8_t)json[i];
+    hash *= 16777619UL;
+  }
+  return (hash == 0) ? 1 : hash;
+}
+
+// Private: Index of a field, -1 if unknown
+int SIM7600DeltaEncoder::find(const char *key) const
+{
+  for (uint8_t i = 0; i < fieldCount; i++)
+  {
+    if (strcmp(fields[i].key, key) == 0)
+      return i;
+  }
+  return -1;
+}
+
+// Private: Set a field to already encoded JSON
+bool SIM7600DeltaEncoder::store(const char *key, const String &json)
+{
+  int i = find(key);
+  if (i == -1)
+  {
+    if (fieldCount >= SIM7600_DELTA_FIELDS)
+    {
+      SerialMon.println("Error: Delta field table full (SIM7600_DELTA_FIELDS)");
+      return false;
+    }
+    i = fieldCount++;
+    fields[i].key = key;
+  }
+  fields[i].value = json;
+  fields[i].current = hashValue(json);
+  return true;
+}
+
+// Public: Integer field
+bool SIM7600DeltaEncoder::set(const char *key, long value)
+{
+  return store(key, String(value));
+}
+
+// Public: Unsigned integer field (counters, epoch seconds)
+bool SIM7600DeltaEncoder::set(const char *key, unsigned long value)
+{
+  return store(key, String(value));
+}
+
+// Public: Decimal field (NaN/inf become null, which JSON has no number for)
+bool SIM7600DeltaEncoder::set(const char *key, double value, uint8_t decimals)
+{
+  if (isnan(value) || isinf(value))
+    return store(key, "null");
+  return store(key, String(value, decimals));
+}
+
+// Public: Boolean field
+bool SIM7600DeltaEncoder::set(const char *key, bool value)
+{
+  return store(key, value ? "true" : "false");
+}
+
+// Public: String field
+bool SIM7600DeltaEncoder::set(const char *key, const char *value)
+{
+  String json = "\"";
+  for (const char *p = value; *p; p++)
+  {
+    char c = *p;
+    if (c == '"' || c == '\\')
+    {
+      json += '\\';
+      json += c;
+    }
+    else if (c == '\n')
+      json += "\\n";
+    else if (c == '\r')
+      json += "\\r";
+    else if ((uint8_t)c < 0x20)
+      json += ' '; // Other control characters are not worth \u escapes here
+    else
+      json += c;
+  }
+  json += '"';
+  return store(key, json);
+}
+
+// Public: Drop a field from the record
+void SIM7600DeltaEncoder::remove(const char *key)
+{
+  int i = find(key);
+  if (i != -1)
+  {
+    fields[i].value = "";
+    fields[i].current = 0;
+  }
+}
+
+// Public: Encode the next record against the acknowledged base
+String SIM7600DeltaEncoder::encode()
+{
+  unsigned long startUs = clock->micros();
+  seq++;
+  bool full = needSnapshot || !haveBase || sinceSnapshot >= snapshotEvery;
+
+  String body = "{\"seq\":" + String(seq);
+  if (stream != nullptr)
+  {
+    body += ",\"stream\":\"" + String(stream) + "\"";
+  }
+  unsigned long fullLen = body.length() + 13; // ,"full":true}
+  if (full)
+    body += ",\"full\":true";
+  else
+    body += ",\"base\":" + String(baseSeq);
+
+  for (uint8_t i = 0; i < fieldCount; i++)
+  {
+    Field &f = fields[i];
+    f.pending = f.current;
+    if (f.current != 0)
+      fullLen += strlen(f.key) + f.value.length() + 4; // ,"key":value
+
+    if (full ? f.current == 0 : f.current == f.acked)
+      continue;
+    body += ",\"" + String(f.key) + "\":";
+    body += (f.current != 0) ? f.value : "null";
+  }
+  body += "}";
+
+  if (full)
+  {
+    counters.snapshots++;
+    sinceSnapshot = 0;
+    needSnapshot = false;
+  }
+  sinceSnapshot++;
+  counters.records++;
+  counters.sentBytes += body.length();
+  counters.fullBytes += fullLen;
+  counters.encodeUs += clock->micros() - startUs;
+  return body;
+}
+
+// Private: True if the body has "resync" with the value true (not just a later true elsewhere)
+bool SIM7600DeltaEncoder::resyncRequested(const String &body)
+{
+  int key = body.indexOf("\"resync\"");
+  if (key == -1)
+    return false;
+  const char *p = body.c_str() + key + 8;
+  while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+    p++;
+  if (*p++ != ':')
+    return false;
+  while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+    p++;
+  return strncmp(p, "true", 4) == 0;
+}
+
+// Public: Apply {"ack":n} or {"resync":true} from the server
+bool SIM7600DeltaEncoder::handleResponse(const String &body)
+{
+  if (resyncRequested(body))
+  {
+    counters.resyncs++;
+    needSnapshot = true;
+    haveBase = false;
+    DEBUG_PRINTLN("Delta: server requested a resync");
+    return true;
+  }
+
+  int ack = body.indexOf("\"ack\"");
+  if (ack == -1)
+    return false;
+  int colon = body.indexOf(':', ack);
+  if (colon == -1)
+    return false;
+  uint32_t acked = strtoul(body.c_str() + colon + 1, nullptr, 10);
+  if (acked != seq)
+  {
+    DEBUG_PRINTLN("Delta: ignoring ack for older record " + String(acked));
+    return true; // Only the latest record's field hashes are kept
+  }
+
+  for (uint8_t i = 0; i < fieldCount; i++)
+  {
+    fields[i].acked = fields[i].pending;
+  }
+  baseSeq = acked;
+  haveBase = true;
+  counters.acks++;
+  return true;
+}
+
+// Public: Send the next record and apply the server's answer
+bool SIM7600DeltaEncoder::post(SIM7600HTTPS &modem, String &response)
+{
+  String body = encode();
+  if (!modem.httpPost(body.c_str(), response))
+    return false;
+  handleResponse(response);
+  return true;
+}
@@ -0,0 +1,88 @@
+#ifndef SIM7600DELTA_H  // Prevent multiple inclusions
+#define SIM7600DELTA_H
+
+#include <Arduino.h>
+#include "SIM7600HTTPS.h"
+// Notes:
+// - Delta encoding of periodic JSON telemetry. Fields keep their last value; encode() sends only the
+//   fields that differ from the last record the server acknowledged, plus a sequence number:
+//     full:  {"seq":12,"full":true,"temp":21.5,"hum":40}
+//     delta: {"seq":13,"base":12,"temp":21.6}          (removed fields are sent as null)
+// - The server answers {"ack":<seq>} once it has stored a record, or {"resync":true} if it lost the
+//   base. Only the ack of the latest record moves the base forward.
+// - A full snapshot is sent first, after a resync, and every SIM7600_DELTA_SNAPSHOT_EVERY records.
+// - Keys are not copied: pass string literals or other storage that outlives the encoder.
+// - Changes are detected by a 32-bit FNV-1a hash of each value's JSON text, not the text itself
+//   (saves a String per field). A new value whose hash equals the acked one (about 1 in 4e9 per
+//   change) is not sent; the next snapshot corrects it.
+
+// Fields per stream
+#ifndef SIM7600_DELTA_FIELDS
+  #define SIM7600_DELTA_FIELDS 12
+#endif
+// Records between forced full snapshots
+#ifndef SIM7600_DELTA_SNAPSHOT_EVERY
+  #define SIM7600_DELTA_SNAPSHOT_EVERY 20
+#endif
+
+struct SIM7600DeltaStats {
+  unsigned long records = 0;      // encode() calls
+  unsigned long snapshots = 0;    // Of which full
+  unsigned long acks = 0;         // Acks that moved the base
+  unsigned long resyncs = 0;      // Resync requests from the server
+  unsigned long sentBytes = 0;    // Bodies produced
+  unsigned long fullBytes = 0;    // What full snapshots would have been
+  unsigned long encodeUs = 0;     // Time spent in encode()
+};
+
+class SIM7600DeltaEncoder {
+public:
+  SIM7600DeltaEncoder(const char* streamId = nullptr, SIM7600Clock& clk = SIM7600SystemClock);
+
+  // Set field values (false if the field table is full)
+  bool set(const char* key, int value) { return set(key, (long)value); }
+  bool set(const char* key, unsigned int value) { return set(key, (unsigned long)value); }
+  bool set(const char* key, long value);
+  bool set(const char* key, unsigned long value);
+  bool set(const char* key, double value, uint8_t decimals = 2);
+  bool set(const char* key, bool value);
+  bool set(const char* key, const char* value);  // JSON string
+  void remove(const char* key);                   // Sent as null in the next delta
+
+  String encode();                          // Body of the next record (full or delta)
+  bool handleResponse(const String& body);  // Apply ack/resync, true if either was found
+  bool post(SIM7600HTTPS& modem, String& response);  // encode() + httpPost() + handleResponse()
+
+  void requestSnapshot() { needSnapshot = true; }
+  void setSnapshotInterval(unsigned int records) { snapshotEvery = records; }
+  uint32_t lastSeq() const { return seq; }
+  const SIM7600DeltaStats& stats() const { return counters; }
+
+private:
+  struct Field {
+    const char* key = nullptr;
+    String value = "";      // JSON text of the current value
+    uint32_t current = 0;   // Hash of value, 0 = absent
+    uint32_t pending = 0;   // Hash in the last record sent
+    uint32_t acked = 0;     // Hash in the acknowledged base
+  };
+
+  bool store(const char* key, const String& json);
+  int find(const char* key) const;
+  static uint32_t hashValue(const String& json);
+  static bool resyncRequested(const String& body);
+
+  Field fields[SIM7600_DELTA_FIELDS];
+  uint8_t fieldCount = 0;
+  const char* stream;
+  SIM7600Clock* clock;
+  uint32_t seq = 0;              // Sequence number of the last record sent
+  uint32_t baseSeq = 0;          // Acknowledged record deltas refer to
+  bool haveBase = false;
+  bool needSnapshot = true;
+  unsigned int snapshotEvery = SIM7600_DELTA_SNAPSHOT_EVERY;
+  unsigned int sinceSnapshot = 0;
+  SIM7600DeltaStats counters;
+};
+
+#endif  // End of include guard
@@ -1,7 +1,8 @@
 #include "SIM7600HTTPS.h"
+#include "SIM7600Power.h"
 
 // Constructor
-SIM7600HTTPS::SIM7600HTTPS()
+SIM7600HTTPS::SIM7600HTTPS(Stream &stream, SIM7600Clock &clk) : at(&stream), clock(&clk)
 {
 }
 
@@ -9,7 +10,7 @@ SIM7600HTTPS::SIM7600HTTPS()
 String SIM7600HTTPS::sendATCommand(const char *cmd, const char *expected, unsigned long timeout)
 {
   clearSerialBuffer(); // Clear any residual data
-  SerialAT.println(cmd);
+  at->println(cmd);
   DEBUG_PRINT("Command: ");
   DEBUG_PRINTLN(cmd);                        // Print command on timeout
   return waitForResponse(expected, timeout); // Wait for the specified response
@@ -19,14 +20,14 @@ String SIM7600HTTPS::sendATCommand(const char *cmd, const char *expected, unsign
 String SIM7600HTTPS::waitForResponse(const char *expected, unsigned long timeout)
 {
   String response = "";
-  unsigned long startTime = millis();
+  unsigned long startTime = clock->millis();
   const int MAX_RESPONSE_LEN = 4096; // Safety limit for large responses
 
-  while (millis() - startTime < timeout)
+  while (clock->millis() - startTime < timeout)
   {
-    while (SerialAT.available())
+    while (at->available())
     {
-      char c = SerialAT.read();
+      char c = at->read();
       response += c;
 
       // Safety: prevent runaway buffer growth
@@ -47,7 +48,7 @@ String SIM7600HTTPS::waitForResponse(const char *expected, unsigned long timeout
       return response;
     }
 
-    delay(10); // Small delay to avoid tight loop
+    clock->delay(10); // Small delay to avoid tight loop
   }
 
   // Timeout - return what we got
@@ -55,12 +56,12 @@ String SIM7600HTTPS::waitForResponse(const char *expected, unsigned long timeout
   DEBUG_PRINTLN(response);
   return response;
 }
-// Private: Clear SerialAT buffer
+// Private: Clear AT stream buffer
 void SIM7600HTTPS::clearSerialBuffer()
 {
-  while (SerialAT.available())
+  while (at->available())
   {
-    SerialAT.read();
+    at->read();
   }
 }
 
@@ -161,6 +162,9 @@ void SIM7600HTTPS::sendATCSQ(bool &success)
       csqEnd = response.indexOf("\r", csqStart);
     String rssiStr = response.substring(csqStart, csqEnd);
     int rssi = rssiStr.toInt();
+    radio.rssi = rssi;
+    radio.valid = true;
+    radio.updatedAt = clock->millis();
 
     if (rssi < 10 || rssi == 99)
     {
@@ -270,17 +274,17 @@ void SIM7600HTTPS::sendCGACT(bool &success)
     return;
 
   // Step 1: Check current PDP context state with AT+CGACT?
-  SerialAT.println("AT+CGACT?");
+  at->println("AT+CGACT?");
   DEBUG_PRINT("Command: ");
   DEBUG_PRINTLN("AT+CGACT?");
 
   String response = "";
-  unsigned long startTime = millis();
-  while (millis() - startTime < 1000)
+  unsigned long startTime = clock->millis();
+  while (clock->millis() - startTime < 1000)
   { // 1-second timeout for CGACT?
-    while (SerialAT.available())
+    while (at->available())
     {
-      char c = SerialAT.read();
+      char c = at->read();
       response += c;
       if (response.indexOf("OK") != -1)
       { // Wait for complete response ending with OK
@@ -295,7 +299,7 @@ void SIM7600HTTPS::sendCGACT(bool &success)
         break; // Proceed to activation if not active
       }
     }
-    delay(10);
+    clock->delay(10);
   }
   // Step 2: If not active, send AT+CGACT=1,1
   response = sendATCommand("AT+CGACT=1,1", "OK", 1000);
@@ -317,18 +321,18 @@ void SIM7600HTTPS::sendATCGPADDR(bool &success)
     return;
 
   // Send command silently
-  SerialAT.println("AT+CGPADDR=1");
+  at->println("AT+CGPADDR=1");
   DEBUG_PRINT("Command: ");
   DEBUG_PRINTLN("AT+CGPADDR=1");
 
   // Wait for complete response (+CGPADDR: 1,<ip>)
   String response = "";
-  unsigned long startTime = millis();
-  while (millis() - startTime < 2000)
+  unsigned long startTime = clock->millis();
+  while (clock->millis() - startTime < 2000)
   { // 5-second timeout
-    while (SerialAT.available())
+    while (at->available())
     {
-      char c = SerialAT.read();
+      char c = at->read();
       response += c;
       // Check for full IP address line (ends with newline after IP)
       if (response.indexOf("+CGPADDR: 1,") != -1 && response.indexOf("\r\n", response.indexOf("+CGPADDR: 1,")) != -1)
@@ -350,7 +354,7 @@ void SIM7600HTTPS::sendATCGPADDR(bool &success)
         return; // Exit once full IP is received
       }
     }
-    delay(10);
+    clock->delay(10);
   }
 
   // Timeout case
@@ -365,18 +369,18 @@ void SIM7600HTTPS::sendATHTTPTERM(bool &success)
     return;
 
   // Send command silently
-  SerialAT.println("AT+HTTPTERM");
+  at->println("AT+HTTPTERM");
   DEBUG_PRINT("Command: ");
   DEBUG_PRINTLN("AT+HTTPTERM");
 
   // Wait for response
   String response = "";
-  unsigned long startTime = millis();
-  while (millis() - startTime < 1000)
+  unsigned long startTime = clock->millis();
+  while (clock->millis() - startTime < 1000)
   { // 1-second timeout
-    while (SerialAT.available())
+    while (at->available())
     {
-      char c = SerialAT.read();
+      char c = at->read();
       response += c;
       if (response.indexOf("OK") != -1 || response.indexOf("ERROR") != -1)
       {
@@ -397,7 +401,7 @@ void SIM7600HTTPS::sendATHTTPTERM(bool &success)
         // return;  // Success - OK or ERROR means termination complete
       }
     }
-    delay(10);
+    clock->delay(10);
   }
 
   // Timeout or unexpected response
@@ -412,18 +416,18 @@ void SIM7600HTTPS::sendATHTTPINIT(bool &success)
     return;
 
   // Send AT+HTTPINIT silently
-  SerialAT.println("AT+HTTPINIT");
+  at->println("AT+HTTPINIT");
   DEBUG_PRINT("Command: ");
   DEBUG_PRINTLN("AT+HTTPINIT");
 
   // Wait for response
   String response = "";
-  unsigned long startTime = millis();
-  while (millis() - startTime < 1000)
+  unsigned long startTime = clock->millis();
+  while (clock->millis() - startTime < 1000)
   { // 1-second timeout
-    while (SerialAT.available())
+    while (at->available())
     {
-      char c = SerialAT.read();
+      char c = at->read();
       response += c;
       if (response.indexOf("OK") != -1 || response.indexOf("ERROR") != -1)
       {
@@ -477,7 +481,7 @@ void SIM7600HTTPS::sendATHTTPPARA(bool &success, const char *param, const char *
     else
     {
       DEBUG_PRINTLN("Retry " + String(retry) + "/" + String(maxRetries) + " for parameter " + String(param) + " failed");
-      delay(10); // Brief delay before retry
+      clock->delay(10); // Brief delay before retry
     }
   }
 
@@ -489,7 +493,7 @@ void SIM7600HTTPS::sendATHTTPPARA(bool &success, const char *param, const char *
   }
 }
 
-void SIM7600HTTPS::sendATHTTPDATA(bool &success, const char *data)
+void SIM7600HTTPS::sendATHTTPDATA(bool &success, const char *data, size_t gzipLen)
 {
   if (!success)
     return;
@@ -513,28 +517,33 @@ void SIM7600HTTPS::sendATHTTPDATA(bool &success, const char *data)
 
   SerialMon.print("Payload length (strlen): ");
   SerialMon.println(dataLen);
+  if (gzipLen > 0)
+  {
+    SerialMon.print("Compressed length (gzip): ");
+    SerialMon.println(gzipLen);
+  }
 
   // Step 1: Send AT+HTTPDATA=<len>,10000
-  String cmd = "AT+HTTPDATA=" + String(dataLen) + ",10000";
-  SerialAT.println(cmd);
+  String cmd = "AT+HTTPDATA=" + String(gzipLen > 0 ? gzipLen : dataLen) + ",10000";
+  at->println(cmd);
 
   DEBUG_PRINT("→ HTTPDATA cmd: ");
   DEBUG_PRINTLN(cmd);
 
   // Wait for DOWNLOAD prompt
   String rsp = "";
-  unsigned long t0 = millis();
-  while (millis() - t0 < 10000)
+  unsigned long t0 = clock->millis();
+  while (clock->millis() - t0 < 10000)
   {
-    while (SerialAT.available())
+    while (at->available())
     {
-      char c = SerialAT.read();
+      char c = at->read();
       rsp += c;
       if (rsp.indexOf("DOWNLOAD") != -1)
         goto prompt_received;
       DEBUG_PRINT(c);
     }
-    delay(1);
+    clock->delay(1);
   }
   SerialMon.println("Timeout waiting for DOWNLOAD");
   success = false;
@@ -547,29 +556,33 @@ prompt_received:
   const int CHUNK = 256; // safe value for most modules
   size_t sent = 0;
 
-  while (sent < dataLen)
+  if (gzipLen > 0)
+  {
+    SIM7600Deflate::gzip((const uint8_t *)data, dataLen, *at); // Streams straight to the UART
+  }
+  while (gzipLen == 0 && sent < dataLen)
   {
     size_t toSend = min(CHUNK, dataLen - sent);
-    SerialAT.write(data + sent, toSend);
+    at->write(data + sent, toSend);
     sent += toSend;
   }
 
-  SerialAT.flush(); // ← ADD THIS HERE
+  at->flush(); // ← ADD THIS HERE
   DEBUG_PRINTLN("Flush completed — all bytes sent to UART");
 
   // Step 3: Wait for final OK
   rsp = "";
-  t0 = millis();
-  while (millis() - t0 < 10000)
+  t0 = clock->millis();
+  while (clock->millis() - t0 < 10000)
   { // generous timeout for large payloads
-    while (SerialAT.available())
+    while (at->available())
     {
-      char c = SerialAT.read();
+      char c = at->read();
       rsp += c;
       if (rsp.indexOf("OK") != -1)
         goto ok_received;
     }
-    delay(1);
+    clock->delay(1);
   }
 
   SerialMon.println("Timeout waiting for OK after data");
@@ -589,24 +602,24 @@ void SIM7600HTTPS::sendATHTTPACTION(bool &success, int method, int &responseLeng
   clearSerialBuffer(); // Flush any stale RX data
 
   // Send command silently
-  unsigned long cmdSentAt = millis(); // ← stamp exactly when command left
+  unsigned long cmdSentAt = clock->millis(); // ← stamp exactly when command left
   String cmd = "AT+HTTPACTION=" + String(method);
-  SerialAT.println(cmd);
+  at->println(cmd);
   DEBUG_PRINT("Command: ");
   DEBUG_PRINTLN(cmd);
 
   // Wait for complete response (+HTTPACTION: <method>,<status>,<length>)
   String response = "";
   String expectedStart = "+HTTPACTION: " + String(method) + ",";
-  unsigned long startTime = millis();
-  unsigned long timeoutMs = (method == 0) ? 12500UL : 15000UL;
+  unsigned long startTime = clock->millis();
+  unsigned long timeoutMs = (method == SIM7600_HTTP_GET || method == SIM7600_HTTP_HEAD) ? 12500UL : 15000UL;
   // GET = 10s, POST = 15s
 
-  while (millis() - startTime < timeoutMs)
+  while (clock->millis() - startTime < timeoutMs)
   { // 60-second timeout
-    while (SerialAT.available())
+    while (at->available())
     {
-      char c = SerialAT.read();
+      char c = at->read();
       response += c;
       // Check for full response (ends with newline after length)
       if (response.indexOf(expectedStart) != -1 && response.indexOf("\r\n", response.indexOf(expectedStart)) != -1)
@@ -617,11 +630,13 @@ void SIM7600HTTPS::sendATHTTPACTION(bool &success, int method, int &responseLeng
         int statusEnd = response.indexOf(",", statusStart);
         String statusStr = response.substring(statusStart, statusEnd);
         int status = statusStr.toInt();
+        lastStatusCode = status;
 
         int lengthStart = statusEnd + 1;
         int lengthEnd = response.indexOf("\r\n", lengthStart);
         String lengthStr = response.substring(lengthStart, lengthEnd);
         responseLength = lengthStr.toInt();
+        lastBodyLength = responseLength;
 
         // Log status and length
         if (method == 0)
@@ -632,6 +647,10 @@ void SIM7600HTTPS::sendATHTTPACTION(bool &success, int method, int &responseLeng
         { // POST method
           SerialMon.println("POST code: " + String(status));
         }
+        else
+        {
+          SerialMon.println("HTTP code: " + String(status) + ",Payload Length: " + String(responseLength));
+        }
 
         if (responseLength < 0)
         {
@@ -641,13 +660,13 @@ void SIM7600HTTPS::sendATHTTPACTION(bool &success, int method, int &responseLeng
         return; // Success - full response received
       }
     }
-    delay(10);
+    clock->delay(10);
   }
 
   // Timeout occurred
   // SerialMon.println("Error: HTTP Paction timeout action failed");
   SerialMon.println("Error: HTTP Paction timeout — waited " +
-                    String(millis() - cmdSentAt) + "ms after command sent");
+                    String(clock->millis() - cmdSentAt) + "ms after command sent");
   sendATCommand("AT+HTTPSTATUS?", "OK", 1000);
   success = false;
   responseLength = 0;
@@ -701,28 +720,106 @@ String SIM7600HTTPS::readHTTPResponse(int responseLength, int timeout)
     {
       break;
     }
-    delay(1);
+    clock->delay(1);
   }
   // SerialMon.println("Server Payload: " + fullResponse);  // Print full response always
   // SerialMon.println("Total Bytes Read: " + String(bytesRead));
   return fullResponse;
 }
+// Private: Read one line (up to \n) from the AT stream
+bool SIM7600HTTPS::readLine(String &line, unsigned long timeout)
+{
+  line = "";
+  unsigned long startTime = clock->millis();
+  while (clock->millis() - startTime < timeout)
+  {
+    while (at->available())
+    {
+      char c = at->read();
+      if (c == '\n')
+      {
+        line.trim();
+        return true;
+      }
+      line += c;
+    }
+    clock->delay(1);
+  }
+  return false;
+}
+
+// Private: Binary-safe HTTPREAD of up to size bytes into buf
+// Returns bytes read, 0 at end of body, -1 on error (partial = bytes lost mid-chunk)
+int SIM7600HTTPS::readHTTPChunk(uint8_t *buf, int size, int &partial)
+{
+  partial = 0;
+  at->println("AT+HTTPREAD=" + String(size));
+
+  // Skip OK / blank lines until the DATA header
+  String line;
+  int dataLen = -1;
+  while (readLine(line, 2000))
+  {
+    if (line.startsWith("+HTTPREAD: DATA,"))
+    {
+      dataLen = line.substring(16).toInt();
+      break;
+    }
+    if (line.startsWith("+HTTPREAD: 0"))
+      return 0;
+    if (line.indexOf("ERROR") != -1)
+      return -1;
+  }
+  if (dataLen < 0 || dataLen > size)
+  {
+    DEBUG_PRINTLN("Error: No HTTPREAD data header");
+    return -1;
+  }
+
+  // Raw payload bytes
+  int got = 0;
+  unsigned long startTime = clock->millis();
+  while (got < dataLen && clock->millis() - startTime < 5000)
+  {
+    while (at->available() && got < dataLen)
+    {
+      buf[got++] = at->read();
+    }
+    if (got < dataLen)
+      clock->delay(1);
+  }
+  if (got < dataLen)
+  {
+    DEBUG_PRINTLN("Error: HTTPREAD payload truncated");
+    partial = got;
+    return -1;
+  }
+
+  // Trailer: +HTTPREAD: 0
+  while (readLine(line, 1000))
+  {
+    if (line.startsWith("+HTTPREAD: 0"))
+      break;
+  }
+  return got;
+}
+
 // Private: for reading server payload (Increased timeout to 1000ms)
 String SIM7600HTTPS::sendATCommandSilent(String cmd)
 {
-  SerialAT.println(cmd);
+  at->println(cmd);
   // DEBUG_PRINT("Silent Command: ");
   // DEBUG_PRINTLN(cmd);
   String response = "";
-  unsigned long startTime = millis();
-  while (millis() - startTime < 50)
+  unsigned long startTime = clock->millis();
+  while (clock->millis() - startTime < 50)
   { // Increased from 50ms to 1000ms
-    while (SerialAT.available())
+    while (at->available())
     {
-      char c = SerialAT.read();
+      char c = at->read();
       response += c;
     }
-    delay(1);
+    clock->delay(1);
   }
   // DEBUG_PRINT("Silent Response: ");
   // DEBUG_PRINTLN(response);
@@ -760,10 +857,28 @@ bool SIM7600HTTPS::gprsConnect(const char *apn)
   return success;
 }
 
+// Private: Wake the module if SIM7600Power put it to sleep. After PSM the HTTP service is gone,
+// so a request without a new httpInit cannot go ahead.
+bool SIM7600HTTPS::wakeForRequest(bool needSession)
+{
+  if (power == nullptr || power->awake())
+    return true;
+  if (!power->wake())
+    return false;
+  if (needSession && !sessionActive)
+  {
+    SerialMon.println("Error: HTTP service reset by PSM, call httpInit() again");
+    return false;
+  }
+  return true;
+}
+
 // Public: Initialize HTTP
 bool SIM7600HTTPS::httpInit(const char *server, const char *resource, int method)
 {
   bool success = true;
+  if (!wakeForRequest(false))
+    return false;
 
   sendATCommand("ATE0", "OK", 500);
 
@@ -778,6 +893,9 @@ bool SIM7600HTTPS::httpInit(const char *server, const char *resource, int method
     // delay(100);
     sessionActive = success;
     needsReinit = false;
+    currentUserData = ""; // Fresh session has no custom headers
+    currentResource = ""; // ... and no URL or Content-Type
+    contentSet = false;
   }
 
   if (!success)
@@ -790,12 +908,9 @@ bool SIM7600HTTPS::httpInit(const char *server, const char *resource, int method
     if (success)
     {
       // sendATHTTPPARA(success, "UA", "Mozilla/5.0");
-      if (method == 1)
-      { // Only POST needs Content-Type
-        sendATHTTPPARA(success, "CONTENT", "application/json");
-      }
       paramsSet = true;
       currentResource = resource; // Update current resource
+      currentTls = (strncmp(server, "https", 5) == 0);
     }
   }
   else
@@ -803,6 +918,14 @@ bool SIM7600HTTPS::httpInit(const char *server, const char *resource, int method
     DEBUG_PRINTLN("Same resource - skipping parameter re-setting");
   }
 
+  // Only requests with a body need Content-Type. It lasts for the HTTP session, so a GET and
+  // a POST to the same resource share one setup.
+  if (success && methodHasBody(method) && !contentSet)
+  {
+    sendATHTTPPARA(success, "CONTENT", "application/json");
+    contentSet = success;
+  }
+
   if (!success)
   {
     needsReinit = true; // Force full re-init next time
@@ -817,13 +940,46 @@ bool SIM7600HTTPS::httpInit(const char *server, const char *resource, int method
 
 // Public: Perform HTTP GET
 bool SIM7600HTTPS::httpGet(String &response)
+{
+  return httpRequest(SIM7600_HTTP_GET, nullptr, response);
+}
+// Public: Perform HTTP POST
+bool SIM7600HTTPS::httpPost(const char *data, String &response)
+{
+  return httpRequest(SIM7600_HTTP_POST, data, response);
+}
+// Public: Perform a request with any method
+bool SIM7600HTTPS::httpRequest(int method, const char *data, String &response)
 {
   bool success = true;
+  if (!wakeForRequest(true))
+  {
+    response = "";
+    return false;
+  }
   int responseLength = 0;
-  sendATHTTPACTION(success, 0, responseLength); // 0 = GET
-  if (success)
+  unsigned long wireBytes = 0;
+  if (methodHasBody(method))
   {
-    response = readHTTPResponse(responseLength, 5000);
+    sendPostBody(success, data, wireBytes, methodOverride(method));
+  }
+  else
+  {
+    applyUserData(success, buildUserData("", compression));
+  }
+  bool requestSent = success;
+  sendATHTTPACTION(success, actionMethod(method), responseLength);
+  if (method == SIM7600_HTTP_HEAD)
+  {
+    responseLength = 0; // Headers only, see fetchResponseHeaders
+  }
+  if (requestSent)
+  {
+    recordUsage(currentResource, wireBytes, success ? responseLength : 0);
+  }
+  if (success && method != SIM7600_HTTP_HEAD)
+  {
+    response = compression ? readHTTPBody(responseLength) : readHTTPResponse(responseLength, 5000);
     SerialMon.flush(); // Ensure immediate print
   }
   else
@@ -832,28 +988,572 @@ bool SIM7600HTTPS::httpGet(String &response)
   }
   return success;
 }
-// Public: Perform HTTP POST
-bool SIM7600HTTPS::httpPost(const char *data, String &response)
+
+// Public: HEAD request for status and headers without a body
+bool SIM7600HTTPS::httpHead(SIM7600HttpResponse &info)
+{
+  String unused;
+  info = SIM7600HttpResponse();
+  if (!httpRequest(SIM7600_HTTP_HEAD, nullptr, unused))
+  {
+    info.status = lastStatusCode;
+    return false;
+  }
+  return fetchResponseHeaders(info);
+}
+
+// Public: Read the response headers of the last request (AT+HTTPHEAD)
+bool SIM7600HTTPS::fetchResponseHeaders(SIM7600HttpResponse &info)
+{
+  info = SIM7600HttpResponse();
+  info.status = lastStatusCode;
+  info.bodyLength = lastBodyLength;
+
+  clearSerialBuffer();
+  at->println("AT+HTTPHEAD");
+  DEBUG_PRINTLN("Command: AT+HTTPHEAD");
+
+  // +HTTPHEAD: <len> followed by len raw bytes
+  String line;
+  int headLen = -1;
+  while (readLine(line, 2000))
+  {
+    if (line.startsWith("+HTTPHEAD:"))
+    {
+      headLen = line.substring(10).toInt();
+      break;
+    }
+    if (line.indexOf("ERROR") != -1)
+      break;
+  }
+  if (headLen < 0)
+  {
+    SerialMon.println("Error: No response headers (AT+HTTPHEAD)");
+    return false;
+  }
+
+  String head = "";
+  head.reserve(headLen);
+  unsigned long startTime = clock->millis();
+  while ((int)head.length() < headLen && clock->millis() - startTime < 5000)
+  {
+    while (at->available() && (int)head.length() < headLen)
+    {
+      head += (char)at->read();
+    }
+    if ((int)head.length() < headLen)
+      clock->delay(1);
+  }
+  waitForResponse("OK", 1000);
+  DEBUG_PRINT("Response headers: ");
+  DEBUG_PRINTLN(head);
+  if ((int)head.length() < headLen)
+  {
+    SerialMon.println("Error: Response headers truncated");
+    return false;
+  }
+
+  parseResponseHeaders(head, info);
+  return true;
+}
+
+// Private: Pick Content-Length, ETag, Retry-After and Content-Range out of a header block
+void SIM7600HTTPS::parseResponseHeaders(const String &head, SIM7600HttpResponse &info)
 {
+  int pos = 0;
+  while (pos < (int)head.length())
+  {
+    int end = head.indexOf('\n', pos);
+    if (end == -1)
+      end = head.length();
+    String line = head.substring(pos, end);
+    pos = end + 1;
+
+    int colon = line.indexOf(':');
+    if (colon <= 0)
+      continue; // Status line or blank
+    String name = line.substring(0, colon);
+    String value = line.substring(colon + 1);
+    name.trim();
+    value.trim();
+
+    if (name.equalsIgnoreCase("Content-Length"))
+    {
+      info.contentLength = value.toInt();
+    }
+    else if (name.equalsIgnoreCase("ETag"))
+    {
+      info.etag = value;
+    }
+    else if (name.equalsIgnoreCase("Retry-After") && value.length() > 0 && isDigit(value.charAt(0)))
+    {
+      info.retryAfterSec = value.toInt(); // HTTP-date form is left at -1
+    }
+    else if (name.equalsIgnoreCase("Content-Range") && value.startsWith("bytes ") && value.length() > 6 &&
+             isDigit(value.charAt(6)))
+    {
+      info.rangeStart = value.substring(6).toInt(); // "bytes <first>-<last>/<total>"
+    }
+  }
+}
+
+// Public: Add or replace a custom request header
+bool SIM7600HTTPS::addHeader(const char *name, const char *value)
+{
+  String line = String(name) + ": " + String(value);
+  if (line.indexOf('"') != -1 || line.indexOf('\r') != -1 || line.indexOf('\n') != -1)
+  {
+    SerialMon.println("Error: Header contains quote or line break: " + String(name));
+    return false;
+  }
+
+  String prefix = String(name) + ":";
+  for (uint8_t i = 0; i < headerCount; i++)
+  {
+    if (headers[i].substring(0, prefix.length()).equalsIgnoreCase(prefix))
+    {
+      headers[i] = line;
+      return true;
+    }
+  }
+  if (headerCount >= SIM7600_MAX_HEADERS)
+  {
+    SerialMon.println("Error: Header list full (SIM7600_MAX_HEADERS)");
+    return false;
+  }
+  headers[headerCount++] = line;
+  return true;
+}
+
+// Private: Methods that carry a body (sent with AT+HTTPDATA)
+bool SIM7600HTTPS::methodHasBody(int method)
+{
+  return method == SIM7600_HTTP_POST || method == SIM7600_HTTP_PUT || method == SIM7600_HTTP_PATCH;
+}
+
+// Private: Header that tells the server the real method of an emulated one
+String SIM7600HTTPS::methodOverride(int method)
+{
+  return (method == SIM7600_HTTP_PATCH) ? "X-HTTP-Method-Override: PATCH" : "";
+}
+
+// Private: USERDATA for one request: custom headers, then the library's own
+String SIM7600HTTPS::buildUserData(const String &extraHeaders, bool acceptGzip)
+{
+  String userData = "";
+  for (uint8_t i = 0; i < headerCount; i++)
+  {
+    if (userData.length() > 0)
+      userData += "\\r\\n";
+    userData += headers[i];
+  }
+  if (acceptGzip)
+  {
+    if (userData.length() > 0)
+      userData += "\\r\\n";
+    userData += "Accept-Encoding: gzip";
+  }
+  if (extraHeaders.length() > 0)
+  {
+    if (userData.length() > 0)
+      userData += "\\r\\n";
+    userData += extraHeaders;
+  }
+  return userData;
+}
+// Public: Resumable binary download into sink
+bool SIM7600HTTPS::httpDownload(const char *server, const char *resource, Print &sink, SIM7600DownloadStats &stats,
+                                unsigned long offset, uint8_t maxResumes, uint32_t crcSeed)
+{
+  stats = SIM7600DownloadStats();
+  if (!wakeForRequest(false))
+    return false;
+  SIM7600CRC32 crc;
+  crc.resume(crcSeed); // 0 = CRC of nothing, i.e. a fresh start
+  uint8_t buf[SIM7600_DOWNLOAD_CHUNK];
+  unsigned long confirmed = offset; // Bytes safely written to the sink
+  unsigned long startTime = clock->millis();
+  bool done = false;
+
+  for (int attempt = 0; attempt < maxResumes + 1 && !done; attempt++)
+  {
+    bool success = true;
+    if (attempt > 0)
+    {
+      stats.resumes++;
+      SerialMon.println("Download: resuming at byte " + String(confirmed));
+    }
+
+    // Fresh session each attempt so USERDATA (Range) never leaks into later requests
+    sendATHTTPTERM(success);
+    sendATHTTPINIT(success);
+    sendATHTTPPARA(success, "URL", (String(server) + String(resource)).c_str());
+    currentUserData = "";
+    applyUserData(success, buildUserData((confirmed > 0) ? "Range: bytes=" + String(confirmed) + "-" : "", false));
+    sessionActive = false; // Force full re-init on the next httpInit
+    currentResource = "";
+    currentTls = (strncmp(server, "https", 5) == 0);
+
+    int responseLength = 0;
+    bool actionSent = success;
+    sendATHTTPACTION(success, 0, responseLength);
+    if (actionSent)
+    {
+      recordUsage(String(resource), 0, success ? responseLength : 0);
+    }
+    if (!success)
+      continue;
+    stats.status = lastStatusCode;
+
+    // 206 = resumed; 200 = server ignored Range, discard what we already have
+    unsigned long skip = 0;
+    if (lastStatusCode == 200)
+    {
+      skip = confirmed;
+      stats.bytesRefetched += confirmed;
+    }
+    else if (lastStatusCode != 206)
+    {
+      SerialMon.println("Error: Download failed with HTTP " + String(lastStatusCode));
+      break;
+    }
+    else
+    {
+      // Only append if the server resumed exactly where we asked
+      SIM7600HttpResponse info;
+      if (!fetchResponseHeaders(info) || info.rangeStart != (long)confirmed)
+      {
+        SerialMon.println("Error: Download got Content-Range from " + String(info.rangeStart) + ", expected " + String(confirmed));
+        break;
+      }
+    }
+
+    long remaining = responseLength;
+    while (remaining > 0)
+    {
+      int partial = 0;
+      int n = readHTTPChunk(buf, (remaining < SIM7600_DOWNLOAD_CHUNK) ? remaining : SIM7600_DOWNLOAD_CHUNK, partial);
+      if (n <= 0)
+      {
+        stats.bytesRefetched += partial; // Incomplete chunk is thrown away
+        break;
+      }
+      remaining -= n;
+
+      int from = 0;
+      if (skip > 0)
+      {
+        from = (skip < (unsigned long)n) ? skip : n;
+        skip -= from;
+      }
+      if (from < n)
+      {
+        size_t len = n - from;
+        if (sink.write(buf + from, len) != len)
+        {
+          SerialMon.println("Error: Download sink full");
+          stats.elapsedMs = clock->millis() - startTime;
+          return false;
+        }
+        crc.update(buf + from, len);
+        confirmed += len;
+        stats.bytesWritten += len;
+      }
+    }
+    done = (remaining == 0);
+  }
+
+  stats.elapsedMs = clock->millis() - startTime;
+  stats.bytesPerSecond = (stats.elapsedMs > 0) ? (unsigned long)((uint64_t)stats.bytesWritten * 1000UL / stats.elapsedMs) : stats.bytesWritten;
+  stats.crc32 = crc.value();
+  if (!done)
+  {
+    SerialMon.println("Error: Download incomplete at byte " + String(confirmed));
+  }
+  return done;
+}
+
+// Public: Start a GET/POST without waiting for +HTTPACTION
+bool SIM7600HTTPS::beginHttpAction(int method, const char *data)
+{
+  if (asyncState != ASYNC_IDLE)
+  {
+    SerialMon.println("Error: HTTP request already in progress");
+    return false;
+  }
+  if (!wakeForRequest(true))
+    return false;
+
   bool success = true;
-  int responseLength = 0;
-  sendATHTTPDATA(success, data);
-  sendATHTTPACTION(success, 1, responseLength); // 1 = POST
+  unsigned long wireBytes = 0;
+  if (methodHasBody(method))
+  {
+    sendPostBody(success, data, wireBytes, methodOverride(method)); // Bounded by the DOWNLOAD/OK exchange, not the server
+  }
+  else
+  {
+    applyUserData(success, buildUserData("", compression));
+  }
+  if (!success)
+    return false;
+
+  clearSerialBuffer(); // Flush any stale RX data
+  asyncMethod = actionMethod(method);
+  String cmd = "AT+HTTPACTION=" + String(asyncMethod);
+  at->println(cmd);
+  DEBUG_PRINT("Command: ");
+  DEBUG_PRINTLN(cmd);
+
+  asyncStart = clock->millis();
+  asyncTimeout = (asyncMethod == SIM7600_HTTP_GET || asyncMethod == SIM7600_HTTP_HEAD) ? 12500UL : 15000UL; // Same limits as sendATHTTPACTION
+  asyncBuf = "";
+  asyncBody = "";
+  asyncRemaining = 0;
+  asyncTx = wireBytes;
+  asyncState = ASYNC_ACTION;
+  return true;
+}
+
+// Public: Advance the request started by beginHttpAction
+int SIM7600HTTPS::pollHttp()
+{
+  if (asyncState == ASYNC_ACTION)
+  {
+    while (at->available())
+    {
+      asyncBuf += (char)at->read();
+    }
+
+    String expectedStart = "+HTTPACTION: " + String(asyncMethod) + ",";
+    int start = asyncBuf.indexOf(expectedStart);
+    if (start != -1 && asyncBuf.indexOf("\r\n", start) != -1)
+    {
+      DEBUG_PRINT("Response: ");
+      DEBUG_PRINTLN(asyncBuf);
+      int statusStart = asyncBuf.indexOf(",", start) + 1;
+      int statusEnd = asyncBuf.indexOf(",", statusStart);
+      lastStatusCode = asyncBuf.substring(statusStart, statusEnd).toInt();
+      int lengthEnd = asyncBuf.indexOf("\r\n", statusEnd + 1);
+      asyncRemaining = asyncBuf.substring(statusEnd + 1, lengthEnd).toInt();
+      lastBodyLength = asyncRemaining;
+      if (asyncMethod == SIM7600_HTTP_HEAD)
+        asyncRemaining = 0; // Headers only
+      asyncBuf = "";
+      recordUsage(currentResource, asyncTx, (asyncRemaining > 0) ? asyncRemaining : 0);
+      if (asyncRemaining < 0)
+      {
+        SerialMon.println("Error: Invalid HTTP action response length");
+        asyncState = ASYNC_IDLE;
+        return SIM7600_FAILED;
+      }
+      asyncState = ASYNC_READ;
+      return SIM7600_PENDING;
+    }
+
+    if (clock->millis() - asyncStart >= asyncTimeout)
+    {
+      SerialMon.println("Error: HTTP Paction timeout — waited " +
+                        String(clock->millis() - asyncStart) + "ms after command sent");
+      recordUsage(currentResource, asyncTx, 0);
+      asyncBuf = "";
+      asyncState = ASYNC_IDLE;
+      return SIM7600_FAILED;
+    }
+    return SIM7600_PENDING;
+  }
+
+  if (asyncState == ASYNC_READ)
+  {
+    if (asyncRemaining <= 0)
+    {
+      asyncState = ASYNC_IDLE;
+      return SIM7600_DONE;
+    }
+
+    // One chunk per poll
+    uint8_t buf[SIM7600_DOWNLOAD_CHUNK];
+    int partial = 0;
+    int n = readHTTPChunk(buf, (asyncRemaining < SIM7600_DOWNLOAD_CHUNK) ? asyncRemaining : SIM7600_DOWNLOAD_CHUNK, partial);
+    if (n < 0)
+    {
+      asyncState = ASYNC_IDLE;
+      return SIM7600_FAILED;
+    }
+    for (int i = 0; i < n; i++)
+    {
+      asyncBody += (char)buf[i];
+    }
+    asyncRemaining -= n;
+    if (n == 0)
+    {
+      SerialMon.println("Error: HTTP body ended " + String(asyncRemaining) + " bytes short");
+      asyncState = ASYNC_IDLE;
+      asyncBody = "";
+      return SIM7600_FAILED;
+    }
+    if (asyncRemaining <= 0)
+    {
+      asyncState = ASYNC_IDLE;
+      if (compression && !inflateBody(asyncBody))
+        return SIM7600_FAILED;
+      return SIM7600_DONE;
+    }
+    return SIM7600_PENDING;
+  }
+
+  return SIM7600_FAILED; // Nothing in progress
+}
+
+// Private: Send a POST body, gzip-compressed when enabled and worthwhile
+void SIM7600HTTPS::sendPostBody(bool &success, const char *data, unsigned long &wireBytes, const String &extraHeaders)
+{
+  if (!success || data == nullptr)
+  {
+    sendATHTTPDATA(success, data); // Reports the NULL payload
+    return;
+  }
+
+  size_t dataLen = strlen(data);
+  size_t gzipLen = 0;
+  if (compression && dataLen >= SIM7600_COMPRESS_MIN)
+  {
+    SIM7600ByteCounter counter; // Dry run: HTTPDATA needs the length up front
+    SIM7600Deflate::gzip((const uint8_t *)data, dataLen, counter);
+    if (counter.count < dataLen)
+      gzipLen = counter.count;
+  }
+
+  String extra = extraHeaders;
+  if (gzipLen > 0)
+    extra += (extra.length() > 0) ? "\\r\\nContent-Encoding: gzip" : "Content-Encoding: gzip";
+  applyUserData(success, buildUserData(extra, compression));
+  sendATHTTPDATA(success, data, gzipLen);
+
+  wireBytes = (gzipLen > 0) ? gzipLen : dataLen;
+  if (compression && success)
+  {
+    compressionCounters.txRaw += dataLen;
+    compressionCounters.txWire += wireBytes;
+  }
+}
+
+// Private: Set custom request headers, skipping the AT command if unchanged
+void SIM7600HTTPS::applyUserData(bool &success, const String &headers)
+{
+  if (!success || headers == currentUserData)
+    return;
+  if (headers.length() > SIM7600_MAX_USERDATA)
+  {
+    SerialMon.println("Error: Request headers exceed SIM7600_MAX_USERDATA");
+    success = false;
+    return;
+  }
+  sendATHTTPPARA(success, "USERDATA", headers.c_str());
   if (success)
+    currentUserData = headers;
+}
+
+// Private: Byte source over the remaining HTTPREAD chunks
+int SIM7600HTTPS::pullBodyByte(void *ctx)
+{
+  BodySource *src = (BodySource *)ctx;
+  if (src->pos >= src->len)
   {
-    response = readHTTPResponse(responseLength, 5000);
+    if (src->remaining <= 0)
+      return -1;
+    int partial = 0;
+    int n = src->modem->readHTTPChunk(src->buf, (src->remaining < SIM7600_DOWNLOAD_CHUNK) ? src->remaining : SIM7600_DOWNLOAD_CHUNK, partial);
+    if (n <= 0)
+      return -1;
+    src->remaining -= n;
+    src->len = n;
+    src->pos = 0;
+  }
+  return src->buf[src->pos++];
+}
+
+// Private: Byte source over a String already in memory
+struct StringSource
+{
+  const String *text;
+  unsigned int pos;
+};
+
+static int pullStringByte(void *ctx)
+{
+  StringSource *src = (StringSource *)ctx;
+  return (src->pos < src->text->length()) ? (uint8_t)(*src->text)[src->pos++] : -1;
+}
+
+// Private: Read the response body chunk by chunk, inflating gzip on the fly
+String SIM7600HTTPS::readHTTPBody(int responseLength)
+{
+  String body = "";
+  if (responseLength <= 0)
+    return body;
+
+  uint8_t buf[SIM7600_DOWNLOAD_CHUNK];
+  BodySource src = {this, buf, 0, 0, responseLength};
+  int first = pullBodyByte(&src); // Fills the first chunk
+  if (first < 0)
+    return body;
+  src.pos = 0;
+  compressionCounters.rxWire += responseLength;
+
+  if (SIM7600Inflate::isGzip(buf, src.len))
+  {
+    if (!SIM7600Inflate::gunzip(pullBodyByte, &src, body))
+    {
+      SerialMon.println("Error: Corrupt gzip response");
+      body = "";
+    }
+    while (pullBodyByte(&src) >= 0)
+      ; // Drain anything after the gzip member
   }
   else
   {
-    response = "";
+    int c;
+    while ((c = pullBodyByte(&src)) >= 0)
+      body += (char)c;
   }
-  return success;
+  compressionCounters.rxRaw += body.length();
+  return body;
+}
+
+// Private: Inflate a complete body in place if it is gzip
+bool SIM7600HTTPS::inflateBody(String &body)
+{
+  if (!SIM7600Inflate::isGzip((const uint8_t *)body.c_str(), body.length()))
+    return true;
+
+  StringSource src = {&body, 0};
+  String plain = "";
+  compressionCounters.rxWire += body.length();
+  if (!SIM7600Inflate::gunzip(pullStringByte, &src, plain))
+  {
+    SerialMon.println("Error: Corrupt gzip response");
+    body = "";
+    return false;
+  }
+  compressionCounters.rxRaw += plain.length();
+  body = plain;
+  return true;
 }
+
+// Public: Hand over the body of the finished request
+String SIM7600HTTPS::takeHttpResponse()
+{
+  String body = asyncBody;
+  asyncBody = "";
+  return body;
+}
+
 // Public: Terminate HTTP Session
 bool SIM7600HTTPS::httpTerm()
 {
   bool success = true;
   sendATHTTPTERM(success); // Terminate HTTP session
+  currentUserData = "";
 #ifndef DumpAtCommands
   if (success)
   {
@@ -865,4 +1565,333 @@ bool SIM7600HTTPS::httpTerm()
   }
 #endif
   return success;
+}
+
+// Public: Re-read signal quality (CSQ) and LTE serving cell metrics (CPSI) when stale
+bool SIM7600HTTPS::refreshRadioMetrics(bool force)
+{
+  if (!force && radio.valid && clock->millis() - radio.updatedAt < radioRefreshMs)
+    return true; // Cache still fresh
+  if (asyncState != ASYNC_IDLE || balancePending)
+    return false; // Don't interleave with a request in flight
+
+  String response = sendATCommand("AT+CSQ", "OK", 1000);
+  int csqStart = response.indexOf("+CSQ:");
+  if (csqStart == -1)
+  {
+    DEBUG_PRINTLN("Error: No CSQ response for radio metrics");
+    return false;
+  }
+  radio.rssi = response.substring(csqStart + 6, response.indexOf(",", csqStart)).toInt();
+
+  response = sendATCommand("AT+CPSI?", "OK", 1000);
+  parseCPSI(response);
+
+  radio.valid = true;
+  radio.updatedAt = clock->millis();
+  DEBUG_PRINTLN("Radio: RSSI " + String(radio.rssi) + ", RSRP " + String(radio.rsrp) +
+                ", RSRQ " + String(radio.rsrq) + ", SINR " + String(radio.sinr));
+  return true;
+}
+
+// Private: +CPSI: LTE,Online,<mcc-mnc>,<tac>,<cellid>,<pcid>,<band>,<earfcn>,<dlbw>,<ulbw>,<rsrq>,<rsrp>,<rssi>,<rssnr>
+void SIM7600HTTPS::parseCPSI(const String &response)
+{
+  radio.lte = false;
+  radio.rsrp = radio.rsrq = radio.sinr = 0; // Unknown unless this is an LTE cell
+  int start = response.indexOf("+CPSI: LTE,");
+  if (start == -1)
+    return; // GSM/WCDMA or no service: only CSQ is available
+
+  int end = response.indexOf("\r\n", start);
+  String fields = response.substring(start + 7, (end == -1) ? response.length() : end);
+
+  // Walk to field 10 (RSRQ); RSRQ/RSRP are reported in tenths of dB/dBm
+  int pos = 0;
+  for (int i = 0; i < 10 && pos != -1; i++)
+  {
+    pos = fields.indexOf(",", pos);
+    if (pos != -1)
+      pos++;
+  }
+  if (pos == -1)
+    return;
+
+  int rsrqEnd = fields.indexOf(",", pos);
+  int rsrpEnd = fields.indexOf(",", rsrqEnd + 1);
+  int rssiEnd = fields.indexOf(",", rsrpEnd + 1);
+  if (rsrqEnd == -1 || rsrpEnd == -1 || rssiEnd == -1)
+    return;
+
+  radio.rsrq = fields.substring(pos, rsrqEnd).toInt() / 10;
+  radio.rsrp = fields.substring(rsrqEnd + 1, rsrpEnd).toInt() / 10;
+  radio.sinr = fields.substring(rssiEnd + 1).toInt();
+  radio.lte = true;
+}
+
+// Public: Should a transfer of this class go out now?
+bool SIM7600HTTPS::linkAllows(uint8_t transferClass, size_t bytes)
+{
+  if (transferClass == SIM7600_TRANSFER_URGENT)
+    return true; // Never held back
+  refreshRadioMetrics();
+  return (sendPolicy == nullptr) || sendPolicy(radio, transferClass, bytes);
+}
+
+// Public: Default policy - usable link for normal traffic, good link for bulk
+bool SIM7600HTTPS::defaultSendPolicy(const SIM7600RadioMetrics &radio, uint8_t transferClass, size_t bytes)
+{
+  if (!radio.valid || transferClass == SIM7600_TRANSFER_URGENT)
+    return true; // No data to judge by
+
+  if (radio.rssi == 99 || radio.rssi < SIM7600_NORMAL_MIN_RSSI)
+    return false;
+  if (transferClass == SIM7600_TRANSFER_BULK || bytes >= SIM7600_BULK_BYTES)
+  {
+    if (radio.rssi < SIM7600_BULK_MIN_RSSI)
+      return false;
+    if (radio.lte && radio.rsrp < SIM7600_BULK_MIN_RSRP)
+      return false;
+  }
+  return true;
+}
+
+// Private: FNV-1a hash of a resource path (never 0, which marks a free slot)
+uint32_t SIM7600HTTPS::hashResource(const char *resource)
+{
+  uint32_t hash = 2166136261UL;
+  while (*resource)
+  {
+    hash ^= (uint8_t)*resource++;
+    hash *= 16777619UL;
+  }
+  return (hash == 0) ? 1 : hash;
+}
+
+// Private: Add one request to the endpoint's counters
+void SIM7600HTTPS::recordUsage(const String &resource, unsigned long txBytes, unsigned long rxBytes)
+{
+  uint32_t key = hashResource(resource.c_str());
+  int slot = SIM7600_MAX_ENDPOINTS - 1; // Endpoints that do not fit share the last slot...
+  for (int i = 0; i < SIM7600_MAX_ENDPOINTS - 1; i++)
+  {
+    if (usage[i].key == key || usage[i].key == 0)
+    {
+      slot = i;
+      break;
+    }
+  }
+  if (slot == SIM7600_MAX_ENDPOINTS - 1)
+    usage[slot].key = hashResource(SIM7600_OTHER_ENDPOINTS); // ... labelled as such
+  else if (usage[slot].key == 0)
+    usage[slot].key = key;
+
+  // Headers both ways, plus a full handshake and per-record framing for https
+  unsigned long overhead = SIM7600_EST_REQUEST_HEADERS + resource.length() + SIM7600_EST_RESPONSE_HEADERS;
+  if (currentTls)
+  {
+    overhead += SIM7600_EST_TLS_HANDSHAKE;
+    overhead += SIM7600_EST_TLS_RECORD * (2 + txBytes / 16384 + rxBytes / 16384);
+  }
+
+  usage[slot].requests++;
+  usage[slot].txBytes += txBytes;
+  usage[slot].rxBytes += rxBytes;
+  usage[slot].overheadBytes += overhead;
+}
+
+// Public: Counters for one endpoint
+const SIM7600EndpointUsage *SIM7600HTTPS::endpointUsage(const char *resource) const
+{
+  uint32_t key = hashResource(resource);
+  for (int i = 0; i < SIM7600_MAX_ENDPOINTS; i++)
+  {
+    if (usage[i].key == key)
+      return &usage[i];
+  }
+  return nullptr;
+}
+
+// Public: Total bytes across all endpoints
+unsigned long SIM7600HTTPS::totalDataUsage() const
+{
+  unsigned long total = 0;
+  for (int i = 0; i < SIM7600_MAX_ENDPOINTS; i++)
+  {
+    total += usage[i].txBytes + usage[i].rxBytes + usage[i].overheadBytes;
+  }
+  return total;
+}
+
+// Public: Clear all endpoint counters
+void SIM7600HTTPS::resetDataUsage()
+{
+  for (int i = 0; i < SIM7600_MAX_ENDPOINTS; i++)
+  {
+    usage[i] = SIM7600EndpointUsage();
+  }
+}
+
+// Public: Check data balance via USSD (blocking)
+String SIM7600HTTPS::checkDataBalance(String ussdCode)
+{
+  if (!beginDataBalanceQuery(ussdCode.c_str()))
+    return "";
+
+  int state = SIM7600_PENDING;
+  while (state == SIM7600_PENDING)
+  {
+    state = pollDataBalance();
+    if (state == SIM7600_PENDING)
+      clock->delay(10);
+  }
+  return (state == SIM7600_DONE) ? balanceReply : "";
+}
+
+// Public: Send AT+CUSD and return without waiting for the network
+bool SIM7600HTTPS::beginDataBalanceQuery(const char *ussdCode)
+{
+  if (asyncState != ASYNC_IDLE || balancePending)
+  {
+    SerialMon.println("Error: Modem busy - balance query not started");
+    return false;
+  }
+
+  clearSerialBuffer();
+  String cmd = "AT+CUSD=1,\"" + String(ussdCode) + "\",15";
+  at->println(cmd);
+  DEBUG_PRINT("Command: ");
+  DEBUG_PRINTLN(cmd);
+
+  balanceBuf = "";
+  balanceStart = clock->millis();
+  balancePending = true;
+  return true;
+}
+
+// Public: Check for the +CUSD reply
+int SIM7600HTTPS::pollDataBalance()
+{
+  if (!balancePending)
+    return SIM7600_FAILED;
+
+  while (at->available())
+  {
+    balanceBuf += (char)at->read();
+  }
+
+  int start = balanceBuf.indexOf("+CUSD:");
+  int end = (start != -1) ? cusdEnd(balanceBuf, start) : -1;
+  if (end != -1)
+  {
+    balancePending = false;
+    DEBUG_PRINT("Response: ");
+    DEBUG_PRINTLN(balanceBuf);
+    finishBalanceQuery(balanceBuf.substring(start, end));
+    balanceBuf = "";
+    return (balanceReply.length() > 0) ? SIM7600_DONE : SIM7600_FAILED;
+  }
+
+  if (balanceBuf.indexOf("ERROR") != -1 || clock->millis() - balanceStart >= 20000)
+  {
+    SerialMon.println("Error: No USSD reply for balance query");
+    balancePending = false;
+    balanceBuf = "";
+    return SIM7600_FAILED;
+  }
+  return SIM7600_PENDING;
+}
+
+// Private: End of a complete +CUSD reply starting at start, -1 while text may still follow.
+// The text can span several lines (menus, carrier notices), so the reply ends at ",<dcs>.
+int SIM7600HTTPS::cusdEnd(const String &buf, int start)
+{
+  int lineEnd = buf.indexOf("\r\n", start);
+  if (lineEnd == -1)
+    return -1;
+  int open = buf.indexOf('"', start);
+  if (open == -1 || open > lineEnd)
+    return lineEnd; // +CUSD: <n> without text (session ended, not supported)
+
+  for (int close = buf.indexOf("\",", open + 1); close != -1; close = buf.indexOf("\",", close + 1))
+  {
+    unsigned int p = close + 2;
+    while (p < buf.length() && isDigit(buf.charAt(p)))
+      p++;
+    if (p > (unsigned int)close + 2 && p + 1 < buf.length() && buf.charAt(p) == '\r' && buf.charAt(p + 1) == '\n')
+      return p;
+  }
+  return -1;
+}
+
+// Private: Extract text from +CUSD: <n>,"<text>",<dcs> and run the parser
+void SIM7600HTTPS::finishBalanceQuery(const String &response)
+{
+  int textStart = response.indexOf('"');
+  int textEnd = response.lastIndexOf('"');
+  balanceReply = (textStart != -1 && textEnd > textStart) ? response.substring(textStart + 1, textEnd) : "";
+
+  // +CUSD: 1 means the network waits for menu input - close the session
+  if (response.startsWith("+CUSD: 1"))
+  {
+    sendATCommand("AT+CUSD=2", "OK", 1000);
+  }
+
+  if (balanceParser != nullptr && balanceReply.length() > 0)
+  {
+    long kb = balanceParser(balanceReply);
+    if (kb >= 0)
+      balanceKB = kb;
+  }
+  DEBUG_PRINTLN("USSD reply: " + balanceReply);
+}
+
+// Public: Default balance parser - first number followed by GB, MB or KB
+long SIM7600HTTPS::parseDataBalance(const String &reply)
+{
+  for (unsigned int i = 0; i < reply.length(); i++)
+  {
+    if (!isDigit(reply.charAt(i)))
+      continue;
+
+    // Number with optional decimals. A comma before exactly three digits groups thousands
+    // ("1,024 MB"); before one or two digits it is a decimal comma ("1,5 GB").
+    unsigned int end = i;
+    String number = "";
+    while (end < reply.length())
+    {
+      char c = reply.charAt(end);
+      if (isDigit(c) || c == '.')
+      {
+        number += c;
+        end++;
+        continue;
+      }
+      if (c != ',' || end + 1 >= reply.length() || !isDigit(reply.charAt(end + 1)))
+        break;
+      unsigned int digits = end + 1;
+      while (digits < reply.length() && isDigit(reply.charAt(digits)))
+        digits++;
+      if (digits - end - 1 != 3)
+        number += '.';
+      end++;
+    }
+    float value = number.toFloat();
+
+    unsigned int unit = end;
+    while (unit < reply.length() && reply.charAt(unit) == ' ')
+      unit++;
+    char scale = toupper(reply.charAt(unit));
+    if (toupper(reply.charAt(unit + 1)) == 'B')
+    {
+      if (scale == 'G')
+        return (long)(value * 1024.0 * 1024.0);
+      if (scale == 'M')
+        return (long)(value * 1024.0);
+      if (scale == 'K')
+        return (long)value;
+    }
+    i = end; // Not a data amount, keep scanning
+  }
+  return -1;
 }
\ No newline at end of file
@@ -2,8 +2,14 @@
 #define SIM7600HTTPS_H
 
 #include <Arduino.h>  // Include Arduino core for Serial, String, etc.
+#include "SIM7600Clock.h"  // Pluggable time source
+#include "SIM7600CRC32.h"  // Streaming checksum for downloads
+#include "SIM7600Deflate.h"  // gzip for POST bodies and responses
+
+class SIM7600Power;  // Optional sleep manager, woken before requests
 // Notes:
 // - Requires SerialMon and SerialAT to be defined in the .ino (e.g., #define SerialMon Serial, #define SerialAT Serial1)
+// - SerialAT is only the default port; pass a Stream to the constructor to drive several modems
 
 
 // Define serial ports if not already defined in .ino
@@ -26,13 +32,154 @@
   #define DEBUG_PRINTLN(x)
 #endif
 
+// Binary download chunk size (bytes per AT+HTTPREAD)
+#ifndef SIM7600_DOWNLOAD_CHUNK
+  #define SIM7600_DOWNLOAD_CHUNK 256
+#endif
+
+// pollHttp() results
+#define SIM7600_FAILED  -1
+#define SIM7600_PENDING 0
+#define SIM7600_DONE    1
+
+// HTTP methods (AT+HTTPACTION codes; PATCH is not supported by the module and is emulated)
+#define SIM7600_HTTP_GET    0
+#define SIM7600_HTTP_POST   1
+#define SIM7600_HTTP_HEAD   2
+#define SIM7600_HTTP_DELETE 3
+#define SIM7600_HTTP_PUT    4
+#define SIM7600_HTTP_PATCH  5  // Sent as POST with X-HTTP-Method-Override: PATCH
+
+// Custom request headers, sent through AT+HTTPPARA="USERDATA"
+#ifndef SIM7600_MAX_HEADERS
+  #define SIM7600_MAX_HEADERS 4
+#endif
+#ifndef SIM7600_MAX_USERDATA
+  #define SIM7600_MAX_USERDATA 256  // Longest USERDATA string the module accepts
+#endif
+
+// Status and selected headers of the last response (fetchResponseHeaders / httpHead)
+struct SIM7600HttpResponse {
+  int status = 0;
+  long bodyLength = 0;       // Length reported by +HTTPACTION
+  long contentLength = -1;   // Content-Length header, -1 if absent
+  String etag = "";          // ETag header as sent (with quotes)
+  long retryAfterSec = -1;   // Retry-After in seconds, -1 if absent or given as an HTTP date
+  long rangeStart = -1;      // First byte of Content-Range (206), -1 if absent
+};
+
+// Result of httpDownload()
+struct SIM7600DownloadStats {
+  unsigned long bytesWritten = 0;    // Bytes delivered to the sink in this call
+  unsigned long bytesRefetched = 0;  // Bytes received twice because of a dropped link
+  uint8_t resumes = 0;               // Range requests issued after a failure
+  unsigned long elapsedMs = 0;
+  unsigned long bytesPerSecond = 0;  // Effective throughput (written bytes only)
+  uint32_t crc32 = 0;                // CRC-32 of crcSeed's bytes followed by the bytes written
+  int status = 0;                    // Last HTTP status code (200/206)
+};
+
+// Data usage accounting: the first SIM7600_MAX_ENDPOINTS - 1 resource paths get their own counters,
+// any further ones are added up under SIM7600_OTHER_ENDPOINTS
+#ifndef SIM7600_MAX_ENDPOINTS
+  #define SIM7600_MAX_ENDPOINTS 8
+#endif
+#define SIM7600_OTHER_ENDPOINTS "*"  // endpointUsage() key of the overflow bucket
+// Estimated per-request overhead not visible to the library (bytes)
+#ifndef SIM7600_EST_REQUEST_HEADERS
+  #define SIM7600_EST_REQUEST_HEADERS 160   // Request line, Host, User-Agent, Content-* headers
+#endif
+#ifndef SIM7600_EST_RESPONSE_HEADERS
+  #define SIM7600_EST_RESPONSE_HEADERS 220  // Status line and typical response headers
+#endif
+#ifndef SIM7600_EST_TLS_HANDSHAKE
+  #define SIM7600_EST_TLS_HANDSHAKE 4500    // Full handshake incl. certificate chain (new connection per request)
+#endif
+#define SIM7600_EST_TLS_RECORD 29           // Header + nonce + tag per TLS record (16 KB max)
+
+struct SIM7600EndpointUsage {
+  uint32_t key = 0;                 // FNV-1a hash of the resource path (0 = unused)
+  unsigned int requests = 0;
+  unsigned long txBytes = 0;        // Request bodies sent
+  unsigned long rxBytes = 0;        // Response bodies received
+  unsigned long overheadBytes = 0;  // Estimated HTTP headers + TLS
+};
+
+// Compression: POST bodies shorter than this are sent uncompressed
+#ifndef SIM7600_COMPRESS_MIN
+  #define SIM7600_COMPRESS_MIN 128
+#endif
+
+struct SIM7600CompressionStats {
+  unsigned long txRaw = 0;   // POST body bytes before compression
+  unsigned long txWire = 0;  // POST body bytes sent to the modem
+  unsigned long rxWire = 0;  // Response body bytes read from the modem
+  unsigned long rxRaw = 0;   // Response body bytes after inflate
+};
+
+// Radio metrics cache and send policy
+#ifndef SIM7600_RADIO_REFRESH_MS
+  #define SIM7600_RADIO_REFRESH_MS 30000  // Minimum age before CSQ/CPSI are re-read
+#endif
+#ifndef SIM7600_NORMAL_MIN_RSSI
+  #define SIM7600_NORMAL_MIN_RSSI 10      // Same floor as the init() signal check
+#endif
+#ifndef SIM7600_BULK_MIN_RSSI
+  #define SIM7600_BULK_MIN_RSSI 15
+#endif
+#ifndef SIM7600_BULK_MIN_RSRP
+  #define SIM7600_BULK_MIN_RSRP -105      // dBm
+#endif
+#ifndef SIM7600_BULK_BYTES
+  #define SIM7600_BULK_BYTES 4096         // Transfers at least this large are treated as bulk
+#endif
+
+// Transfer classes for linkAllows()
+#define SIM7600_TRANSFER_URGENT 0  // Always sent
+#define SIM7600_TRANSFER_NORMAL 1  // Needs a usable link
+#define SIM7600_TRANSFER_BULK   2  // Needs a good link
+
+struct SIM7600RadioMetrics {
+  int rssi = 99;                // AT+CSQ 0-31, 99 = unknown
+  int rsrp = 0;                 // LTE RSRP in dBm (AT+CPSI?), 0 = unknown
+  int rsrq = 0;                 // LTE RSRQ in dB, 0 = unknown
+  int sinr = 0;                 // LTE SINR in dB
+  bool lte = false;             // Serving cell is LTE (RSRP/RSRQ/SINR valid)
+  bool valid = false;           // At least one successful read
+  unsigned long updatedAt = 0;  // Time of the last read
+};
+
+// Send policy: return true to send now, false to defer
+typedef bool (*SIM7600SendPolicy)(const SIM7600RadioMetrics& radio, uint8_t transferClass, size_t bytes);
+
+// USSD balance parser: returns remaining data in KB, or -1 if the reply has no balance
+typedef long (*SIM7600BalanceParser)(const String& reply);
 
 class SIM7600HTTPS {
 public:
-  // Constructor
-  SIM7600HTTPS();
+  // Constructor: each instance owns its AT stream and time source
+  SIM7600HTTPS(Stream& stream = SerialAT, SIM7600Clock& clk = SIM7600SystemClock);
 //check Data balance
-  String checkDataBalance(String ussdCode);
+  String checkDataBalance(String ussdCode);  // Blocking USSD query, returns the network's reply text
+  bool beginDataBalanceQuery(const char* ussdCode);  // Start USSD query without waiting for the reply
+  int pollDataBalance();                             // SIM7600_PENDING / SIM7600_DONE / SIM7600_FAILED
+  long dataBalanceKB() const { return balanceKB; }  // Last parsed balance, -1 if unknown
+  String dataBalanceReply() const { return balanceReply; }  // Text of the last USSD reply
+  void setBalanceParser(SIM7600BalanceParser parser) { balanceParser = parser; }
+  static long parseDataBalance(const String& reply);  // Default: first "<n> GB/MB/KB" in the reply
+
+  // Radio metrics (refreshed at most every SIM7600_RADIO_REFRESH_MS) and send gating
+  bool refreshRadioMetrics(bool force = false);
+  const SIM7600RadioMetrics& radioMetrics() const { return radio; }
+  void setRadioRefreshInterval(unsigned long ms) { radioRefreshMs = ms; }
+  bool linkAllows(uint8_t transferClass, size_t bytes = 0);  // Ask the policy using cached metrics
+  void setSendPolicy(SIM7600SendPolicy policy) { sendPolicy = policy; }
+  static bool defaultSendPolicy(const SIM7600RadioMetrics& radio, uint8_t transferClass, size_t bytes);
+
+  // Data usage per endpoint (bodies + estimated HTTP/TLS overhead)
+  const SIM7600EndpointUsage* endpointUsage(const char* resource) const;  // nullptr if never used
+  unsigned long totalDataUsage() const;  // All bytes incl. estimated overhead
+  void resetDataUsage();
 
   // Initialization and GPRS connection
   bool init();                  // Initialize modem (AT, SIM, signal, etc.)
@@ -40,12 +187,42 @@ public:
 
   // HTTP operations
   bool startHttpSession(bool& success);  // Initialize HTTP session
-  bool httpInit(const char* server, const char* resource, int method = 0); // Initialize HTTP with server URL, method (0=GET, 1=POST)
+  bool httpInit(const char* server, const char* resource, int method = 0); // Initialize HTTP with server URL, method (SIM7600_HTTP_*)
   bool httpGet(String& response);// Perform GET request on a resource
   bool httpPost(const char* data, String& response);  // Perform POST request with data
+  // Any SIM7600_HTTP_* method after httpInit. data is the body of POST/PUT/PATCH; HEAD reads no body.
+  bool httpRequest(int method, const char* data, String& response);
+  bool httpHead(SIM7600HttpResponse& info);              // HEAD + response headers, no body (health checks)
+  bool fetchResponseHeaders(SIM7600HttpResponse& info);  // AT+HTTPHEAD of the last request, body left unread
+  // Custom request headers for all following requests (e.g. Authorization)
+  bool addHeader(const char* name, const char* value);  // Replaces a header of the same name; false if full
+  void clearHeaders() { headerCount = 0; }
   bool httpTerm();                 // Terminate HTTP session
+  // Binary GET into sink in fixed chunks, resuming with Range: bytes=N- after a dropped link.
+  // offset > 0 continues a download confirmed by an earlier call; pass that call's stats.crc32 as crcSeed
+  // so crc32 covers the whole file. A 206 whose Content-Range does not start at the resume point is refused.
+  bool httpDownload(const char* server, const char* resource, Print& sink, SIM7600DownloadStats& stats,
+                    unsigned long offset = 0, uint8_t maxResumes = 3, uint32_t crcSeed = 0);
+  int lastStatus() const { return lastStatusCode; }  // HTTP status of the last HTTPACTION
+  // gzip POST bodies (Content-Encoding: gzip) and accept/inflate gzip responses
+  void setCompression(bool enable) { compression = enable; }
+  const SIM7600CompressionStats& compressionStats() const { return compressionCounters; }
+
+  // Non-blocking HTTP: call after httpInit, then pollHttp() from loop() until it stops returning SIM7600_PENDING.
+  // Only the wait for the server (+HTTPACTION) is non-blocking. Still blocking, on module-local exchanges:
+  // - beginHttpAction: USERDATA and, for a body, AT+HTTPDATA (up to 10 s each for DOWNLOAD and OK)
+  // - pollHttp while reading: one AT+HTTPREAD chunk per call, incl. its trailer (up to 2 s + 5 s + 1 s)
+  // - pollHttp on the last chunk of a gzip response: the body is buffered compressed and inflated in one
+  //   go there (buffer-then-inflate; the blocking httpGet/httpPost inflate chunk by chunk instead)
+  bool beginHttpAction(int method, const char* data = nullptr);  // SIM7600_HTTP_* (data required for POST/PUT/PATCH)
+  int pollHttp();                                                // SIM7600_PENDING / SIM7600_DONE / SIM7600_FAILED
+  bool httpBusy() const { return asyncState != ASYNC_IDLE; }
+  String takeHttpResponse();                                     // Body of the finished request
 
 private:
+  friend class SIM7600MQTT;   // Shares the AT port and command helpers
+  friend class SIM7600Power;  // Sleep/wake commands on the same port
+
   // Private helper methods (implementation in .cpp)
   String sendATCommand(const char* cmd, const char* expected, unsigned long timeout);
   String waitForResponse(const char* expected, unsigned long timeout);
@@ -69,15 +246,80 @@ void sendATCEREG(bool &success);
   void sendATHTTPTERM(bool& success);
   void sendATHTTPINIT(bool& success);
   void sendATHTTPPARA(bool& success, const char* param, const char* value, int maxRetries = 3);  // Added maxRetries
-  void sendATHTTPDATA(bool& success, const char* data);
+  void sendATHTTPDATA(bool& success, const char* data, size_t gzipLen = 0);  // gzipLen > 0: send data gzip-compressed
   void sendATHTTPACTION(bool& success, int method, int& responseLength);
   String readHTTPResponse(int responseLength, int timeout);
   String sendATCommandSilent(String cmd); 
+  bool readLine(String& line, unsigned long timeout);  // Read one CRLF-terminated line
+  int readHTTPChunk(uint8_t* buf, int size, int& partial);  // Binary-safe AT+HTTPREAD
+  void sendPostBody(bool& success, const char* data, unsigned long& wireBytes, const String& extraHeaders);
+  void applyUserData(bool& success, const String& headers);  // AT+HTTPPARA="USERDATA" if changed
+  String buildUserData(const String& extraHeaders, bool acceptGzip);  // Custom headers + per-request ones
+  static int actionMethod(int method) { return (method == SIM7600_HTTP_PATCH) ? SIM7600_HTTP_POST : method; }
+  static bool methodHasBody(int method);
+  static String methodOverride(int method);  // X-HTTP-Method-Override for emulated methods
+  static void parseResponseHeaders(const String& head, SIM7600HttpResponse& info);
+  String readHTTPBody(int responseLength);  // Chunked body read with gzip detection
+  bool inflateBody(String& body);           // Inflate in place if gzip
+  struct BodySource {
+    SIM7600HTTPS* modem;
+    uint8_t* buf;
+    int len;
+    int pos;
+    long remaining;
+  };
+  static int pullBodyByte(void* ctx);
+  void parseCPSI(const String& response);
+  void recordUsage(const String& resource, unsigned long txBytes, unsigned long rxBytes);
+  static uint32_t hashResource(const char* resource);
+  void finishBalanceQuery(const String& response);  // Parse +CUSD reply
+  static int cusdEnd(const String& buf, int start);  // End of a complete +CUSD reply, -1 if incomplete
+  bool wakeForRequest(bool needSession);  // Wake a sleeping module (SIM7600Power) before a request
 
   bool paramsSet = false;  // New: Track if parameters are set
   String currentResource = "";  // New: Track current resource for reuse
   bool sessionActive = false;  // Track session state
+  bool contentSet = false;     // CONTENT set in this HTTP session
   bool needsReinit = false;    // New: Flag for re-init on failure
+  SIM7600Power* power = nullptr;  // Set by SIM7600Power::begin()
+  int lastStatusCode = 0;      // HTTP status from the last +HTTPACTION
+  long lastBodyLength = 0;     // Body length from the last +HTTPACTION
+  String headers[SIM7600_MAX_HEADERS];  // "Name: value" set by addHeader
+  uint8_t headerCount = 0;
+
+  // Non-blocking HTTP state
+  enum { ASYNC_IDLE, ASYNC_ACTION, ASYNC_READ };
+  uint8_t asyncState = ASYNC_IDLE;
+  int asyncMethod = 0;
+  unsigned long asyncStart = 0;
+  unsigned long asyncTimeout = 0;
+  long asyncRemaining = 0;     // Body bytes still to read
+  String asyncBuf = "";        // Partial +HTTPACTION line
+  String asyncBody = "";       // Body of the finished request
+  unsigned long asyncTx = 0;   // Request body bytes (for usage accounting)
+
+  // Compression
+  bool compression = false;
+  String currentUserData = "";  // USERDATA set in the current HTTP session
+  SIM7600CompressionStats compressionCounters;
+
+  // Radio metrics
+  SIM7600RadioMetrics radio;
+  unsigned long radioRefreshMs = SIM7600_RADIO_REFRESH_MS;
+  SIM7600SendPolicy sendPolicy = defaultSendPolicy;
+
+  // Data usage and balance
+  SIM7600EndpointUsage usage[SIM7600_MAX_ENDPOINTS];
+  bool currentTls = false;     // Current URL uses https
+  SIM7600BalanceParser balanceParser = parseDataBalance;
+  long balanceKB = -1;
+  bool balancePending = false;
+  unsigned long balanceStart = 0;
+  String balanceBuf = "";
+  String balanceReply = "";
+
+  Stream* at;            // AT command port for this modem
+  SIM7600Clock* clock;   // Time source for timeouts and delays
 };
 
 #endif  // End of include guard
\ No newline at end of file
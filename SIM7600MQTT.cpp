@@ -0,0 +1,344 @@
+#include "SIM7600MQTT.h"
+
+// Constructor
+SIM7600MQTT::SIM7600MQTT(SIM7600HTTPS &m) : modem(&m)
+{
+}
+
+// Private: Read into buf until it contains until (or timeout)
+void SIM7600MQTT::readInto(String &buf, unsigned long timeout, const char *until)
+{
+  unsigned long startTime = modem->clock->millis();
+  while (modem->clock->millis() - startTime < timeout)
+  {
+    while (modem->at->available())
+    {
+      buf += (char)modem->at->read();
+    }
+    if (buf.indexOf(until) != -1 || buf.indexOf("ERROR") != -1)
+      return;
+    modem->clock->delay(1);
+  }
+}
+
+// Private: AT command that keeps URCs (incoming messages) for parseUrcs instead of discarding them
+String SIM7600MQTT::command(const String &cmd, const char *expected, unsigned long timeout)
+{
+  loop(); // Deliver anything that arrived before the command
+  urcMark = urcBuf.length(); // Result URCs before this point belong to earlier commands
+  modem->at->println(cmd);
+  DEBUG_PRINT("Command: ");
+  DEBUG_PRINTLN(cmd);
+
+  String response = "";
+  readInto(response, timeout, expected);
+  DEBUG_PRINT("Response: ");
+  DEBUG_PRINTLN(response);
+  urcBuf += response;
+  parseUrcs();
+  return response;
+}
+
+// Private: Command answered by a '>' prompt, then raw data, then OK
+bool SIM7600MQTT::sendWithPrompt(const String &cmd, const char *data, size_t len)
+{
+  String response = command(cmd, ">", 2000);
+  if (response.indexOf(">") == -1)
+  {
+    DEBUG_PRINTLN("Error: No prompt for " + cmd);
+    return false;
+  }
+  modem->at->write((const uint8_t *)data, len);
+
+  response = "";
+  readInto(response, 2000, "OK");
+  urcBuf += response;
+  parseUrcs();
+  return response.indexOf("OK") != -1;
+}
+
+// Private: Remove part of urcBuf, moving urcMark with the text after it
+void SIM7600MQTT::dropUrc(int start, int len)
+{
+  urcBuf.remove(start, len);
+  if (start < urcMark)
+    urcMark -= (urcMark - start < len) ? urcMark - start : len;
+}
+
+// Private: Wait for a result URC like "+CMQTTPUB: 0,<err>" sent after the last command.
+// A late URC of an earlier, timed-out command sits before urcMark and is not matched.
+bool SIM7600MQTT::waitForUrc(const char *prefix, unsigned long timeout, String &line)
+{
+  unsigned long startTime = modem->clock->millis();
+  do
+  {
+    while (modem->at->available())
+    {
+      urcBuf += (char)modem->at->read();
+    }
+    int start = urcBuf.indexOf(prefix, urcMark);
+    int end = (start != -1) ? urcBuf.indexOf("\r\n", start) : -1;
+    if (end != -1)
+    {
+      line = urcBuf.substring(start, end);
+      dropUrc(start, end + 2 - start);
+      parseUrcs();
+      return true;
+    }
+    modem->clock->delay(1);
+  } while (modem->clock->millis() - startTime < timeout);
+
+  line = "";
+  return false;
+}
+
+// Private: Deliver complete incoming messages and note connection loss
+void SIM7600MQTT::parseUrcs()
+{
+  int lost = urcBuf.indexOf("+CMQTTCONNLOST:");
+  if (lost != -1 && urcBuf.indexOf("\r\n", lost) != -1)
+  {
+    isConnected = false;
+    SerialMon.println("MQTT connection lost");
+    dropUrc(lost, urcBuf.indexOf("\r\n", lost) + 2 - lost);
+  }
+
+  // +CMQTTRXSTART / RXTOPIC <topic> / RXPAYLOAD <data> (one or more) / RXEND
+  for (;;)
+  {
+    int start = urcBuf.indexOf("+CMQTTRXSTART:");
+    if (start == -1)
+      return;
+
+    String topic = "";
+    String payload = "";
+    int pos = urcBuf.indexOf("\r\n", start);
+    bool complete = false;
+    while (pos != -1)
+    {
+      int next = urcBuf.indexOf("+CMQTTRX", pos);
+      int lineEnd = (next != -1) ? urcBuf.indexOf("\r\n", next) : -1;
+      if (lineEnd == -1)
+        break; // Header line not complete yet
+
+      if (urcBuf.substring(next, next + 14) == "+CMQTTRXEND: 0")
+      {
+        dropUrc(start, lineEnd + 2 - start);
+        complete = true;
+        break;
+      }
+
+      // RXTOPIC / RXPAYLOAD: "<prefix>: 0,<len>\r\n" followed by len raw bytes
+      int len = urcBuf.substring(urcBuf.indexOf(",", next) + 1, lineEnd).toInt();
+      int dataStart = lineEnd + 2;
+      if ((int)urcBuf.length() < dataStart + len)
+        break; // Data still arriving
+      if (urcBuf.substring(next, next + 14) == "+CMQTTRXTOPIC:")
+        topic += urcBuf.substring(dataStart, dataStart + len);
+      else
+        payload += urcBuf.substring(dataStart, dataStart + len);
+      pos = dataStart + len;
+    }
+    if (!complete)
+      return; // Wait for the rest of the message
+
+    counters.received++;
+    DEBUG_PRINTLN("MQTT message on " + topic);
+    if (messageCallback)
+      messageCallback(topic, payload);
+  }
+}
+
+// Public: Process URCs
+void SIM7600MQTT::loop()
+{
+  while (modem->at->available())
+  {
+    urcBuf += (char)modem->at->read();
+  }
+  parseUrcs();
+
+  // Keep only a partial message or a partial URC line
+  int keep = urcBuf.indexOf("+CMQTTRXSTART:");
+  if (keep == -1)
+  {
+    int lastPlus = urcBuf.lastIndexOf('+');
+    keep = (lastPlus != -1 && urcBuf.indexOf("\r\n", lastPlus) == -1) ? lastPlus : urcBuf.length();
+  }
+  if (keep > 0)
+    dropUrc(0, keep);
+}
+
+// Public: Store a PEM CA certificate on the module and use it for TLS
+bool SIM7600MQTT::loadCACert(const char *fileName, const char *pem)
+{
+  size_t len = strlen(pem);
+  if (!sendWithPrompt("AT+CCERTDOWN=\"" + String(fileName) + "\"," + String(len), pem, len))
+  {
+    SerialMon.println("Error: Failed to upload CA certificate " + String(fileName));
+    return false;
+  }
+  caFile = fileName;
+  return true;
+}
+
+// Public: Start MQTT service and connect to the broker
+bool SIM7600MQTT::connect(const char *host, uint16_t port, const char *clientId, bool tls,
+                          const char *user, const char *pass, uint16_t keepAliveSec)
+{
+  String line;
+  if (tls && caFile.length() == 0 && !insecure)
+  {
+    SerialMon.println("Error: MQTT TLS needs a CA certificate (loadCACert/setCACert) or setInsecure()");
+    return false;
+  }
+  if (!started)
+  {
+    command("AT+CMQTTSTART", "+CMQTTSTART:", 5000);
+    // 0 = started, 23 = service already running
+    if (!waitForUrc("+CMQTTSTART:", 100, line) ||
+        (line.indexOf("+CMQTTSTART: 0") == -1 && line.indexOf("+CMQTTSTART: 23") == -1))
+    {
+      SerialMon.println("Error: Failed to start MQTT service");
+      return false;
+    }
+    started = true;
+  }
+
+  if (tls)
+  {
+    command("AT+CSSLCFG=\"sslversion\",0,4", "OK", 1000); // Any TLS version
+    command("AT+CSSLCFG=\"enableSNI\",0,1", "OK", 1000);  // Brokers behind shared IPs pick the certificate by name
+    if (caFile.length() > 0)
+    {
+      String response = command("AT+CSSLCFG=\"cacert\",0,\"" + caFile + "\"", "OK", 1000);
+      response += command("AT+CSSLCFG=\"authmode\",0,1", "OK", 1000); // Verify the broker
+      if (response.indexOf("ERROR") != -1)
+      {
+        SerialMon.println("Error: Failed to select CA certificate " + caFile);
+        return false;
+      }
+    }
+    else
+    {
+      SerialMon.println("Warning: MQTT TLS without broker verification (setInsecure)");
+      command("AT+CSSLCFG=\"authmode\",0,0", "OK", 1000);
+    }
+  }
+  command("AT+CMQTTACCQ=0,\"" + String(clientId) + "\"," + String(tls ? 1 : 0), "OK", 1000);
+  if (tls)
+  {
+    command("AT+CMQTTSSLCFG=0,0", "OK", 1000);
+  }
+
+  String cmd = "AT+CMQTTCONNECT=0,\"tcp://" + String(host) + ":" + String(port) + "\"," + String(keepAliveSec) + ",1";
+  if (user != nullptr)
+  {
+    cmd += ",\"" + String(user) + "\",\"" + String(pass ? pass : "") + "\"";
+  }
+  String response = command(cmd, "OK", 2000);
+  if (response.indexOf("ERROR") != -1 || !waitForUrc("+CMQTTCONNECT: 0,", 30000, line))
+  {
+    SerialMon.println("Error: MQTT connect failed");
+    return false;
+  }
+
+  isConnected = line.substring(line.indexOf(",") + 1).toInt() == 0;
+  if (!isConnected)
+  {
+    SerialMon.println("Error: MQTT broker refused connection (" + line + ")");
+  }
+  else
+  {
+    DEBUG_PRINTLN("MQTT connected");
+  }
+  useTls = tls;
+  return isConnected;
+}
+
+// Public: Publish one message
+bool SIM7600MQTT::publish(const char *topic, const char *payload, uint8_t qos, bool retain)
+{
+  if (!isConnected)
+  {
+    SerialMon.println("Error: MQTT not connected");
+    return false;
+  }
+
+  unsigned long startTime = modem->clock->millis();
+  size_t topicLen = strlen(topic);
+  size_t payloadLen = strlen(payload);
+  String line;
+
+  bool ok = sendWithPrompt("AT+CMQTTTOPIC=0," + String(topicLen), topic, topicLen) &&
+            sendWithPrompt("AT+CMQTTPAYLOAD=0," + String(payloadLen), payload, payloadLen);
+  if (ok)
+  {
+    String cmd = "AT+CMQTTPUB=0," + String(qos) + ",60," + String(retain ? 1 : 0);
+    String response = command(cmd, "OK", 1000);
+    ok = response.indexOf("ERROR") == -1 && waitForUrc("+CMQTTPUB: 0,", 20000, line) &&
+         line.substring(line.indexOf(",") + 1).toInt() == 0;
+  }
+
+  if (!ok)
+  {
+    counters.publishFailures++;
+    SerialMon.println("Error: MQTT publish failed " + line);
+    return false;
+  }
+
+  // PUBLISH: fixed header + remaining length + topic length + topic + packet id (QoS 1) + payload
+  unsigned long remaining = 2 + topicLen + (qos > 0 ? 2 : 0) + payloadLen;
+  unsigned long wire = 1 + (remaining < 128 ? 1 : 2) + remaining;
+  if (qos > 0)
+    wire += 4; // PUBACK
+  if (useTls)
+    wire += SIM7600_EST_TLS_RECORD * (qos > 0 ? 2 : 1);
+
+  counters.published++;
+  counters.wireBytes += wire;
+  counters.lastLatencyMs = modem->clock->millis() - startTime;
+  counters.totalLatencyMs += counters.lastLatencyMs;
+  return true;
+}
+
+// Public: Subscribe to a topic filter
+bool SIM7600MQTT::subscribe(const char *topic, uint8_t qos)
+{
+  if (!isConnected)
+  {
+    SerialMon.println("Error: MQTT not connected");
+    return false;
+  }
+
+  size_t topicLen = strlen(topic);
+  String line;
+  if (!sendWithPrompt("AT+CMQTTSUB=0," + String(topicLen) + "," + String(qos), topic, topicLen) ||
+      !waitForUrc("+CMQTTSUB: 0,", 10000, line) || line.substring(line.indexOf(",") + 1).toInt() != 0)
+  {
+    SerialMon.println("Error: MQTT subscribe failed for " + String(topic));
+    return false;
+  }
+  DEBUG_PRINTLN("Subscribed to " + String(topic));
+  return true;
+}
+
+// Public: Disconnect and stop the MQTT service
+void SIM7600MQTT::disconnect()
+{
+  String line;
+  if (isConnected)
+  {
+    command("AT+CMQTTDISC=0,120", "OK", 1000);
+    waitForUrc("+CMQTTDISC: 0,", 5000, line);
+  }
+  command("AT+CMQTTREL=0", "OK", 1000);
+  if (started)
+  {
+    command("AT+CMQTTSTOP", "+CMQTTSTOP:", 5000);
+  }
+  isConnected = false;
+  started = false;
+  urcBuf = "";
+  urcMark = 0;
+}
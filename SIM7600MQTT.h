@@ -0,0 +1,67 @@
+#ifndef SIM7600MQTT_H  // Prevent multiple inclusions
+#define SIM7600MQTT_H
+
+#include <Arduino.h>
+#include "SIM7600HTTPS.h"
+// Notes:
+// - MQTT client on the module's AT+CMQTT* command set: one persistent (TLS) connection
+//   instead of a new HTTPS connection per POST.
+// - Bring the modem up with init() and gprsConnect() first, then call connect().
+// - Call loop() often: incoming messages and connection loss arrive as URCs.
+// - Uses MQTT client index 0 and SSL context 0 of the module.
+// - TLS verifies the broker against a CA certificate stored on the module (loadCACert/setCACert).
+//   connect() with tls refuses to run without one unless setInsecure() was called.
+
+// Incoming message callback
+typedef void (*SIM7600MessageFn)(const String& topic, const String& payload);
+
+struct SIM7600MQTTStats {
+  unsigned long published = 0;        // Publishes confirmed by +CMQTTPUB
+  unsigned long publishFailures = 0;
+  unsigned long received = 0;         // Messages delivered to the callback
+  unsigned long wireBytes = 0;        // Estimated bytes on air for publishes (MQTT + TLS framing)
+  unsigned long lastLatencyMs = 0;    // AT+CMQTTTOPIC to +CMQTTPUB of the last publish
+  unsigned long totalLatencyMs = 0;   // Sum over all confirmed publishes (divide by published)
+};
+
+class SIM7600MQTT {
+public:
+  SIM7600MQTT(SIM7600HTTPS& modem);
+
+  // CA for TLS: upload a PEM to the module's file system, or select one stored there earlier
+  bool loadCACert(const char* fileName, const char* pem);  // AT+CCERTDOWN, then selects it
+  void setCACert(const char* fileName) { caFile = fileName; }
+  void setInsecure() { insecure = true; }  // TLS without broker verification (testing only)
+
+  // Start the MQTT service and connect (tls = true uses SSL context 0, e.g. port 8883)
+  bool connect(const char* host, uint16_t port, const char* clientId, bool tls = true,
+               const char* user = nullptr, const char* pass = nullptr, uint16_t keepAliveSec = 60);
+  bool publish(const char* topic, const char* payload, uint8_t qos = 0, bool retain = false);
+  bool subscribe(const char* topic, uint8_t qos = 0);
+  void onMessage(SIM7600MessageFn cb) { messageCallback = cb; }
+  void loop();                         // Process URCs (incoming messages, connection loss)
+  bool connected() const { return isConnected; }
+  void disconnect();                   // Disconnect, release client, stop service
+  const SIM7600MQTTStats& stats() const { return counters; }
+
+private:
+  String command(const String& cmd, const char* expected, unsigned long timeout);  // URC-preserving AT command
+  bool sendWithPrompt(const String& cmd, const char* data, size_t len);           // Command + '>' + data
+  bool waitForUrc(const char* prefix, unsigned long timeout, String& line);      // "+X: 0,<err>" after the last command
+  void dropUrc(int start, int len);                                                // Remove from urcBuf, keeping urcMark
+  void readInto(String& buf, unsigned long timeout, const char* until);
+  void parseUrcs();                                                                // Handle complete URCs in urcBuf
+
+  SIM7600HTTPS* modem;
+  SIM7600MessageFn messageCallback = nullptr;
+  SIM7600MQTTStats counters;
+  bool isConnected = false;
+  bool started = false;
+  bool useTls = false;
+  String urcBuf = "";
+  int urcMark = 0;             // urcBuf offset where the last command's output starts
+  String caFile = "";
+  bool insecure = false;
+};
+
+#endif  // End of include guard
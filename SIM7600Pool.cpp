@@ -0,0 +1,202 @@
+#include "SIM7600Pool.h"
+
+// Constructor
+SIM7600Pool::SIM7600Pool(SIM7600Clock &clk) : clock(&clk)
+{
+}
+
+// Public: Add a modem to the pool
+bool SIM7600Pool::add(SIM7600HTTPS &modem)
+{
+  if (count >= SIM7600_MAX_MODEMS)
+    return false;
+  slots[count].modem = &modem;
+  count++;
+  return true;
+}
+
+// Public: Number of modems not in failure backoff
+uint8_t SIM7600Pool::healthyCount()
+{
+  uint8_t healthy = 0;
+  unsigned long now = clock->millis();
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (!slots[i].down || (long)(now - slots[i].downUntil) >= 0)
+      healthy++;
+  }
+  return healthy;
+}
+
+// Private: Pick the next healthy modem, round-robin
+int SIM7600Pool::nextModem(unsigned int skip)
+{
+  unsigned long now = clock->millis();
+  for (uint8_t n = 0; n < count; n++)
+  {
+    uint8_t i = (cursor + n) % count;
+    if (slots[i].busy || (skip & (1U << i)))
+      continue; // Running a request, or already tried for this one
+    if (slots[i].down && (long)(now - slots[i].downUntil) < 0)
+      continue; // Still backing off
+    cursor = (i + 1) % count;
+    return i;
+  }
+  return -1;
+}
+
+// Private: Record the outcome of a request
+void SIM7600Pool::report(int index, bool ok)
+{
+  Slot &slot = slots[index];
+  slot.requests++;
+  if (ok)
+  {
+    slot.down = false;
+    return;
+  }
+  slot.failures++;
+  slot.down = true;
+  slot.downUntil = clock->millis() + retryAfterMs;
+  DEBUG_PRINTLN("Pool: modem " + String(index) + " failed, backing off");
+}
+
+// Public: GET on the next healthy modem, failing over on error
+bool SIM7600Pool::httpGet(const char *server, const char *resource, String &response)
+{
+  for (uint8_t attempt = 0; attempt < count; attempt++)
+  {
+    int i = nextModem();
+    if (i == -1)
+      break;
+    SIM7600HTTPS &modem = *slots[i].modem;
+    bool ok = modem.httpInit(server, resource) && modem.httpGet(response);
+    report(i, ok);
+    if (ok)
+      return true;
+  }
+  SerialMon.println("Error: No modem in pool could complete GET");
+  response = "";
+  return false;
+}
+
+// Public: POST on the next healthy modem, failing over on error
+bool SIM7600Pool::httpPost(const char *server, const char *resource, const char *data, String &response)
+{
+  for (uint8_t attempt = 0; attempt < count; attempt++)
+  {
+    int i = nextModem();
+    if (i == -1)
+      break;
+    SIM7600HTTPS &modem = *slots[i].modem;
+    bool ok = modem.httpInit(server, resource, 1) && modem.httpPost(data, response);
+    report(i, ok);
+    if (ok)
+      return true;
+  }
+  SerialMon.println("Error: No modem in pool could complete POST");
+  response = "";
+  return false;
+}
+
+// Private: Start a ticket on the next healthy modem it has not tried yet
+bool SIM7600Pool::start(Ticket &ticket)
+{
+  int i;
+  while ((i = nextModem(ticket.tried)) != -1)
+  {
+    ticket.tried |= 1U << i;
+    SIM7600HTTPS &modem = *slots[i].modem;
+    if (modem.httpInit(ticket.server, ticket.resource, ticket.method) &&
+        modem.beginHttpAction(ticket.method, ticket.data))
+    {
+      slots[i].busy = true;
+      ticket.modem = i;
+      ticket.state = SIM7600_PENDING;
+      return true;
+    }
+    report(i, false);
+  }
+  ticket.modem = -1;
+  ticket.state = SIM7600_FAILED;
+  return false;
+}
+
+// Public: Start a request on the next free healthy modem
+int SIM7600Pool::begin(const char *server, const char *resource, int method, const char *data)
+{
+  int t = 0;
+  while (t < SIM7600_MAX_MODEMS && tickets[t].used)
+    t++;
+  uint8_t saved = cursor;
+  bool free = (t < SIM7600_MAX_MODEMS && nextModem() != -1);
+  cursor = saved; // Only peeked
+  if (!free)
+    return -1; // Every healthy modem is busy
+
+  Ticket &ticket = tickets[t];
+  ticket = Ticket();
+  ticket.used = true;
+  ticket.server = server;
+  ticket.resource = resource;
+  ticket.method = method;
+  ticket.data = data;
+  if (!start(ticket))
+    SerialMon.println("Error: No modem in pool could start the request");
+  return t;
+}
+
+// Public: Advance every request in flight, failing over to the next modem on error
+bool SIM7600Pool::poll()
+{
+  bool pending = false;
+  for (uint8_t t = 0; t < SIM7600_MAX_MODEMS; t++)
+  {
+    Ticket &ticket = tickets[t];
+    if (!ticket.used || ticket.state != SIM7600_PENDING)
+      continue;
+    SIM7600HTTPS &modem = *slots[ticket.modem].modem;
+    int state = modem.pollHttp();
+    if (state == SIM7600_PENDING)
+    {
+      pending = true;
+      continue;
+    }
+
+    slots[ticket.modem].busy = false;
+    report(ticket.modem, state == SIM7600_DONE);
+    if (state == SIM7600_DONE)
+    {
+      ticket.state = SIM7600_DONE;
+      ticket.status = modem.lastStatus();
+      ticket.body = modem.takeHttpResponse();
+    }
+    else if (start(ticket))
+    {
+      pending = true; // Failed over to another modem
+    }
+    else
+    {
+      SerialMon.println("Error: No modem in pool could complete the request");
+    }
+  }
+  return pending;
+}
+
+// Public: State of a request started with begin()
+int SIM7600Pool::result(int ticket) const
+{
+  if (ticket < 0 || ticket >= SIM7600_MAX_MODEMS || !tickets[ticket].used)
+    return SIM7600_FAILED;
+  return tickets[ticket].state;
+}
+
+// Public: Hand over the body of a finished request and free its ticket
+String SIM7600Pool::takeResponse(int ticket)
+{
+  if (ticket < 0 || ticket >= SIM7600_MAX_MODEMS || tickets[ticket].state == SIM7600_PENDING)
+    return "";
+  String body = tickets[ticket].body;
+  tickets[ticket] = Ticket();
+  return body;
+}
@@ -0,0 +1,77 @@
+#ifndef SIM7600POOL_H  // Prevent multiple inclusions
+#define SIM7600POOL_H
+
+#include <Arduino.h>
+#include "SIM7600HTTPS.h"
+// Notes:
+// - Spreads requests across several modems (each with its own Stream) in round-robin order.
+// - A modem whose request fails is skipped for retryAfterMs and the request fails over to the next one.
+// - httpGet/httpPost block until done. For more throughput than one modem, use begin() + poll():
+//   each modem runs one request, and requests on different modems wait for their servers in parallel.
+
+// Maximum number of modems in a pool (override before including if needed)
+#ifndef SIM7600_MAX_MODEMS
+  #define SIM7600_MAX_MODEMS 4
+#endif
+
+class SIM7600Pool {
+public:
+  SIM7600Pool(SIM7600Clock& clk = SIM7600SystemClock);
+
+  bool add(SIM7600HTTPS& modem);  // Add an initialized and connected modem
+  void setRetryAfter(unsigned long ms) { retryAfterMs = ms; }  // Backoff for a failed modem
+
+  // HTTP operations (init + request on the next healthy modem, with failover)
+  bool httpGet(const char* server, const char* resource, String& response);
+  bool httpPost(const char* server, const char* resource, const char* data, String& response);
+
+  // Non-blocking: start a request on the next free healthy modem (strings must stay valid until it ends).
+  // Returns a ticket, -1 if every healthy modem is busy.
+  int begin(const char* server, const char* resource, int method = SIM7600_HTTP_GET, const char* data = nullptr);
+  bool poll();                          // Advance all requests in flight (with failover), true while any is pending
+  int result(int ticket) const;         // SIM7600_PENDING / SIM7600_DONE / SIM7600_FAILED
+  int status(int ticket) const { return (ticket >= 0 && ticket < SIM7600_MAX_MODEMS) ? tickets[ticket].status : 0; }
+  String takeResponse(int ticket);      // Body of a finished request; frees the ticket
+
+  uint8_t size() const { return count; }
+  uint8_t healthyCount();
+  unsigned long requests(uint8_t index) const { return index < count ? slots[index].requests : 0; }
+  unsigned long failures(uint8_t index) const { return index < count ? slots[index].failures : 0; }
+
+private:
+  struct Slot {
+    SIM7600HTTPS* modem = nullptr;
+    unsigned long downUntil = 0;  // Skip until this time after a failure
+    bool down = false;
+    bool busy = false;            // Running a request started with begin()
+    unsigned long requests = 0;
+    unsigned long failures = 0;
+  };
+
+  // One request started with begin()
+  struct Ticket {
+    bool used = false;
+    const char* server = nullptr;
+    const char* resource = nullptr;
+    int method = SIM7600_HTTP_GET;
+    const char* data = nullptr;
+    int8_t modem = -1;            // Modem running it
+    unsigned int tried = 0;       // Bit per modem already tried
+    int state = SIM7600_FAILED;
+    int status = 0;
+    String body = "";
+  };
+
+  int nextModem(unsigned int skip = 0);  // Next healthy, free modem in round-robin order, -1 if none
+  void report(int index, bool ok);  // Update health after a request
+  bool start(Ticket& ticket);       // Start (or fail over) a ticket on the next untried modem
+
+  Slot slots[SIM7600_MAX_MODEMS];
+  Ticket tickets[SIM7600_MAX_MODEMS];  // At most one request per modem
+  uint8_t count = 0;
+  uint8_t cursor = 0;
+  unsigned long retryAfterMs = 30000;
+  SIM7600Clock* clock;
+};
+
+#endif  // End of include guard
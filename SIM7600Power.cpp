@@ -0,0 +1,209 @@
+#include "SIM7600Power.h"
+
+// Shortest idle period worth entering each mode for
+static const unsigned long minIdleMs[SIM7600_SLEEP_MODES] = {0, SIM7600_MIN_IDLE_DTR_MS, SIM7600_MIN_IDLE_EDRX_MS,
+                                                             SIM7600_MIN_IDLE_PSM_MS};
+// Typical current per mode for the charge estimate
+static const unsigned long currentUA[SIM7600_SLEEP_MODES] = {SIM7600_CURRENT_AWAKE_UA, SIM7600_CURRENT_DTR_UA,
+                                                             SIM7600_CURRENT_EDRX_UA, SIM7600_CURRENT_PSM_UA};
+// ... without DTR the UART never sleeps, only the radio does
+static const unsigned long noDtrCurrentUA[SIM7600_SLEEP_MODES] = {SIM7600_CURRENT_AWAKE_UA, SIM7600_CURRENT_AWAKE_UA,
+                                                                  SIM7600_CURRENT_NO_DTR_UA, SIM7600_CURRENT_NO_DTR_UA};
+
+// Constructor
+SIM7600Power::SIM7600Power(SIM7600HTTPS &m, int pin) : modem(&m), dtrPin(pin)
+{
+}
+
+// Destructor
+SIM7600Power::~SIM7600Power()
+{
+  if (modem->power == this)
+    modem->power = nullptr;
+}
+
+// Public: Enable DTR-controlled sleep
+bool SIM7600Power::begin()
+{
+  if (dtrPin >= 0)
+  {
+    pinMode(dtrPin, OUTPUT);
+    digitalWrite(dtrPin, LOW); // DTR low = awake
+  }
+  modeSince = modem->clock->millis();
+  modem->power = this; // Requests wake the module on demand
+  if (dtrPin < 0)
+    return true; // Without DTR the UART could not be woken again; eDRX/PSM need no setup here
+
+  String response = modem->sendATCommand("AT+CSCLK=1", "OK", 1000);
+  if (response.indexOf("OK") == -1)
+  {
+    SerialMon.println("Error: Failed to enable sleep mode (AT+CSCLK)");
+    return false;
+  }
+  DEBUG_PRINTLN("DTR sleep enabled");
+  return true;
+}
+
+// Private: Charge the time since the last transition to the current mode
+void SIM7600Power::account()
+{
+  unsigned long now = modem->clock->millis();
+  counters.timeMs[mode] += now - modeSince;
+  modeSince = now;
+}
+
+// Private: How long before the release to start waking from a mode. A wake twice as slow as
+// estimated then ends at most min(slack, wake cost) after the release.
+unsigned long SIM7600Power::wakeLeadMs(uint8_t m, unsigned long slackMs) const
+{
+  unsigned long cost = wakeCostMs[m];
+  return 2 * cost - ((slackMs < cost) ? slackMs : cost);
+}
+
+// Public: Deepest mode that is worth entering and can still start waking in time
+uint8_t SIM7600Power::chooseMode(unsigned long idleMs, unsigned long slackMs) const
+{
+  for (int m = maxMode; m > SIM7600_SLEEP_NONE; m--)
+  {
+    if (m == SIM7600_SLEEP_DTR && dtrPin < 0)
+      continue; // UART sleep needs the DTR line
+    if (idleMs >= minIdleMs[m] && wakeLeadMs(m, slackMs) < idleMs)
+      return m;
+  }
+  return SIM7600_SLEEP_NONE;
+}
+
+// Public: Sleep between bursts and wake ahead of the next job
+void SIM7600Power::manage(unsigned long msUntilNextJob, unsigned long slackMs)
+{
+  if (mode != SIM7600_SLEEP_NONE)
+  {
+    if (msUntilNextJob <= wakeLeadMs(mode, slackMs))
+      wake(); // Start waking so the module is ready by the deadline even if the wake is slow
+    return;
+  }
+  if (msUntilNextJob == 0 || modem->httpBusy())
+    return; // Work due or in flight
+
+  uint8_t m = chooseMode(msUntilNextJob, slackMs);
+  if (m != SIM7600_SLEEP_NONE)
+    sleep(m);
+}
+
+// Public: Enter a sleep mode
+bool SIM7600Power::sleep(uint8_t m)
+{
+  if (m == mode || m >= SIM7600_SLEEP_MODES)
+    return m == mode;
+  if (mode != SIM7600_SLEEP_NONE && !wake())
+    return false; // Mode changes go through awake
+  if (m == SIM7600_SLEEP_NONE)
+    return true;
+
+  String response = "OK";
+  if (m == SIM7600_SLEEP_EDRX)
+  {
+    response = modem->sendATCommand("AT+CEDRXS=1,4,\"0101\"", "OK", 1000); // LTE, 81.92 s paging cycle
+  }
+  else if (m == SIM7600_SLEEP_PSM)
+  {
+    response = modem->sendATCommand("AT+CPSMS=1,,,\"00100001\",\"00000000\"", "OK", 1000); // TAU 1 h, no active time
+  }
+  if (response.indexOf("OK") == -1)
+  {
+    SerialMon.println("Error: Failed to configure sleep mode " + String(m));
+    return false;
+  }
+
+  account();
+  mode = m;
+  counters.entries[m]++;
+  if (dtrPin >= 0)
+  {
+    digitalWrite(dtrPin, HIGH); // UART sleep (AT+CSCLK=1)
+  }
+  DEBUG_PRINTLN("Modem sleeping, mode " + String(m));
+  return true;
+}
+
+// Public: Wake the module and measure wake-to-first-byte
+bool SIM7600Power::wake()
+{
+  if (mode == SIM7600_SLEEP_NONE)
+    return true;
+
+  uint8_t was = mode;
+  unsigned long startTime = modem->clock->millis();
+  if (dtrPin >= 0)
+  {
+    digitalWrite(dtrPin, LOW);
+  }
+
+  // Poke with AT until the first byte comes back
+  bool answered = false;
+  unsigned long firstByteMs = 0;
+  while (!answered && modem->clock->millis() - startTime < 10000)
+  {
+    modem->clearSerialBuffer();
+    modem->at->println("AT");
+    unsigned long sentAt = modem->clock->millis();
+    while (modem->clock->millis() - sentAt < 200)
+    {
+      if (modem->at->available())
+      {
+        firstByteMs = modem->clock->millis() - startTime;
+        answered = true;
+        break;
+      }
+      modem->clock->delay(1);
+    }
+  }
+  modem->waitForResponse("OK", 500);
+
+  account();
+  mode = SIM7600_SLEEP_NONE;
+  if (!answered)
+  {
+    counters.wakeFailures++;
+    SerialMon.println("Error: Modem did not wake from sleep mode " + String(was));
+    return false;
+  }
+
+  counters.lastWakeMs = firstByteMs;
+  if (firstByteMs > counters.maxWakeMs)
+    counters.maxWakeMs = firstByteMs;
+  wakeCostMs[was] = (3 * wakeCostMs[was] + firstByteMs) / 4; // Track the real cost
+
+  // Leave the network-level modes so downlink and the next request are not delayed
+  if (was == SIM7600_SLEEP_EDRX)
+  {
+    modem->sendATCommand("AT+CEDRXS=0", "OK", 1000);
+  }
+  else if (was == SIM7600_SLEEP_PSM)
+  {
+    modem->sendATCommand("AT+CPSMS=0", "OK", 1000);
+    modem->sessionActive = false; // Radio was off: re-init the HTTP service
+  }
+  DEBUG_PRINTLN("Modem awake after " + String(firstByteMs) + " ms");
+  return true;
+}
+
+// Public: Statistics with the current mode's time included
+const SIM7600PowerStats &SIM7600Power::stats()
+{
+  account();
+  return counters;
+}
+
+// Public: Charge estimate from time per mode and typical currents
+unsigned long SIM7600Power::estimatedChargeUAh()
+{
+  account();
+  uint64_t uAms = 0;
+  for (uint8_t m = 0; m < SIM7600_SLEEP_MODES; m++)
+  {
+    uAms += (uint64_t)counters.timeMs[m] * ((dtrPin >= 0) ? currentUA[m] : noDtrCurrentUA[m]);
+  }
+  return (unsigned long)(uAms / 3600000UL);
+}
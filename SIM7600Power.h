@@ -0,0 +1,103 @@
+#ifndef SIM7600POWER_H  // Prevent multiple inclusions
+#define SIM7600POWER_H
+
+#include <Arduino.h>
+#include "SIM7600HTTPS.h"
+// Notes:
+// - Duty-cycles the module between request bursts: UART sleep via DTR (AT+CSCLK=1),
+//   eDRX (AT+CEDRXS) and PSM (AT+CPSMS).
+// - manage() picks the deepest mode whose wake still fits before the next job and starts waking
+//   2 x wake cost - slack (at most 1 x) ahead of the release, so a wake twice as slow as estimated
+//   still meets the job's deadline. Call it from loop() with scheduler.msUntilNextJob(&slack).
+// - DTR sleep needs the module's DTR line on a GPIO (dtrPin). Without it only eDRX/PSM are used, and
+//   only the radio sleeps: AT+CSCLK stays off, so their time is charged at SIM7600_CURRENT_NO_DTR_UA.
+// - After begin(), httpInit/httpGet/httpPost/beginHttpAction/httpDownload wake the module themselves
+//   if it is asleep. After PSM, call httpInit() again before the next request.
+
+// Sleep modes, lightest to deepest
+#define SIM7600_SLEEP_NONE 0  // Awake
+#define SIM7600_SLEEP_DTR  1  // UART sleep, stays registered
+#define SIM7600_SLEEP_EDRX 2  // UART sleep + extended paging cycle
+#define SIM7600_SLEEP_PSM  3  // Power saving mode, radio off until the next uplink
+#define SIM7600_SLEEP_MODES 4
+
+// Typical wake-to-first-byte cost per mode (ms), refined by measured wakes
+#ifndef SIM7600_WAKE_DTR_MS
+  #define SIM7600_WAKE_DTR_MS 100
+#endif
+#ifndef SIM7600_WAKE_EDRX_MS
+  #define SIM7600_WAKE_EDRX_MS 300
+#endif
+#ifndef SIM7600_WAKE_PSM_MS
+  #define SIM7600_WAKE_PSM_MS 3000
+#endif
+// Shortest idle period for which entering the mode is worth its AT commands (ms)
+#ifndef SIM7600_MIN_IDLE_DTR_MS
+  #define SIM7600_MIN_IDLE_DTR_MS 1000
+#endif
+#ifndef SIM7600_MIN_IDLE_EDRX_MS
+  #define SIM7600_MIN_IDLE_EDRX_MS 20000
+#endif
+#ifndef SIM7600_MIN_IDLE_PSM_MS
+  #define SIM7600_MIN_IDLE_PSM_MS 120000
+#endif
+// Typical module current per mode (uA) for the charge estimate
+#ifndef SIM7600_CURRENT_AWAKE_UA
+  #define SIM7600_CURRENT_AWAKE_UA 23000
+#endif
+#ifndef SIM7600_CURRENT_DTR_UA
+  #define SIM7600_CURRENT_DTR_UA 3000
+#endif
+#ifndef SIM7600_CURRENT_EDRX_UA
+  #define SIM7600_CURRENT_EDRX_UA 1500
+#endif
+#ifndef SIM7600_CURRENT_PSM_UA
+  #define SIM7600_CURRENT_PSM_UA 30
+#endif
+#ifndef SIM7600_CURRENT_NO_DTR_UA
+  #define SIM7600_CURRENT_NO_DTR_UA 18000  // eDRX/PSM with the UART awake (no AT+CSCLK)
+#endif
+
+struct SIM7600PowerStats {
+  unsigned long entries[SIM7600_SLEEP_MODES] = {0, 0, 0, 0};  // Times each mode was entered
+  unsigned long timeMs[SIM7600_SLEEP_MODES] = {0, 0, 0, 0};   // Time spent per mode (index 0 = awake)
+  unsigned long lastWakeMs = 0;                                // Wake-to-first-byte of the last wake
+  unsigned long maxWakeMs = 0;
+  unsigned long wakeFailures = 0;
+};
+
+class SIM7600Power {
+public:
+  SIM7600Power(SIM7600HTTPS& modem, int dtrPin = -1);
+  ~SIM7600Power();
+
+  // Enable DTR-controlled sleep (AT+CSCLK=1) if a DTR pin is set; requests then wake the module on demand
+  bool begin();
+  // Sleep between bursts / wake ahead of the next job. slackMs = allowed lateness of that job
+  // (0 = none allowed, SIM7600_NO_DEADLINE = unlimited).
+  void manage(unsigned long msUntilNextJob, unsigned long slackMs = 0);
+  uint8_t chooseMode(unsigned long idleMs, unsigned long slackMs = 0) const;  // Deepest mode that fits
+  bool sleep(uint8_t mode);
+  bool wake();                         // Returns once the module answers AT again
+  bool awake() const { return mode == SIM7600_SLEEP_NONE; }
+  uint8_t currentMode() const { return mode; }
+
+  void setMaxMode(uint8_t m) { maxMode = m; }  // Cap the depth (e.g. DTR only for MQTT downlink)
+  void setWakeCost(uint8_t m, unsigned long ms) { if (m < SIM7600_SLEEP_MODES) wakeCostMs[m] = ms; }
+  const SIM7600PowerStats& stats();             // Brings the time of the current mode up to date
+  unsigned long estimatedChargeUAh();           // Module charge used so far (uAh) from the typical currents
+
+private:
+  void account();                      // Add time since the last transition to the current mode
+  unsigned long wakeLeadMs(uint8_t m, unsigned long slackMs) const;  // When to start waking before a release
+
+  SIM7600HTTPS* modem;
+  int dtrPin;
+  uint8_t mode = SIM7600_SLEEP_NONE;
+  uint8_t maxMode = SIM7600_SLEEP_PSM;
+  unsigned long modeSince = 0;
+  unsigned long wakeCostMs[SIM7600_SLEEP_MODES] = {0, SIM7600_WAKE_DTR_MS, SIM7600_WAKE_EDRX_MS, SIM7600_WAKE_PSM_MS};
+  SIM7600PowerStats counters;
+};
+
+#endif  // End of include guard
@@ -0,0 +1,212 @@
+#include "SIM7600Scheduler.h"
+
+// Constructor
+SIM7600Scheduler::SIM7600Scheduler(SIM7600Clock &clk) : clock(&clk)
+{
+}
+
+// Private: Find a free slot in the job table
+int SIM7600Scheduler::allocJob()
+{
+  for (int i = 0; i < SIM7600_MAX_JOBS; i++)
+  {
+    if (!jobs[i].active)
+    {
+      jobs[i] = Job(); // Reset stats from any previous occupant
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Public: Add a periodic job
+int SIM7600Scheduler::addPeriodic(SIM7600JobFn fn, void *ctx, unsigned long periodMs, uint8_t priority,
+                                  unsigned long deadlineMs, unsigned long jitterMs, uint8_t flags)
+{
+  if (fn == nullptr || periodMs == 0)
+    return -1;
+  int id = allocJob();
+  if (id == -1)
+    return -1;
+
+  Job &job = jobs[id];
+  job.fn = fn;
+  job.ctx = ctx;
+  job.periodMs = periodMs;
+  job.deadlineMs = (deadlineMs == 0) ? periodMs : deadlineMs;
+  job.jitterMs = jitterMs;
+  job.priority = priority;
+  job.flags = flags;
+  job.anchor = clock->millis();
+  job.release = job.anchor; // First run is due immediately
+  job.active = true;
+  return id;
+}
+
+// Public: Add a one-shot job
+int SIM7600Scheduler::addOneShot(SIM7600JobFn fn, void *ctx, unsigned long delayMs, uint8_t priority,
+                                 unsigned long deadlineMs)
+{
+  if (fn == nullptr)
+    return -1;
+  int id = allocJob();
+  if (id == -1)
+    return -1;
+
+  Job &job = jobs[id];
+  job.fn = fn;
+  job.ctx = ctx;
+  job.deadlineMs = deadlineMs;
+  job.priority = priority;
+  job.anchor = clock->millis() + delayMs;
+  job.release = job.anchor;
+  job.active = true;
+  return id;
+}
+
+// Public: Remove a job
+bool SIM7600Scheduler::remove(int id)
+{
+  if (id < 0 || id >= SIM7600_MAX_JOBS || !jobs[id].active)
+    return false;
+  jobs[id].active = false;
+  return true;
+}
+
+// Private: Move a periodic job to its next release
+void SIM7600Scheduler::advance(Job &job)
+{
+  job.anchor += job.periodMs;
+  job.release = job.anchor;
+  job.held = false;
+  if (job.jitterMs > 0)
+  {
+    job.release += random(job.jitterMs + 1);
+  }
+}
+
+// Private: Fold releases that were overtaken while the modem was busy
+void SIM7600Scheduler::catchUp(int id, unsigned long now)
+{
+  Job &job = jobs[id];
+  if (job.periodMs == 0 || !reached(now, job.release))
+    return;
+
+  // A whole period has passed since the pending release - merge into the latest one
+  unsigned long behind = now - job.anchor;
+  if (behind >= job.periodMs)
+  {
+    unsigned long skipped = behind / job.periodMs;
+    job.anchor += skipped * job.periodMs;
+    job.release = job.anchor;
+    job.held = false; // A new release, deferred afresh if the gate is still closed
+    job.stats.merged += skipped;
+  }
+
+  // Stale instance: deadline already gone, skip it instead of sending old data late
+  if ((job.flags & SIM7600_JOB_DROP_STALE) && (long)(now - (job.release + job.deadlineMs)) > 0)
+  {
+    job.stats.dropped++;
+    job.stats.deadlineMisses++;
+    if (missCallback)
+      missCallback(id, now - (job.release + job.deadlineMs));
+    advance(job);
+  }
+}
+
+// Public: Run the most urgent due job (one per call)
+bool SIM7600Scheduler::run()
+{
+  unsigned long now = clock->millis();
+  int best = -1;
+  unsigned long bestDeadline = 0;
+
+  for (int i = 0; i < SIM7600_MAX_JOBS; i++)
+  {
+    if (!jobs[i].active)
+      continue;
+    catchUp(i, now);
+    Job &job = jobs[i];
+    if (!reached(now, job.release) || job.priority < priorityFloor)
+      continue;
+
+    // Jobs without a deadline sort after those with one at the same priority
+    unsigned long deadline = (job.deadlineMs == 0) ? now + 0x7FFFFFFFUL : job.release + job.deadlineMs;
+    if (best == -1 || job.priority > jobs[best].priority ||
+        (job.priority == jobs[best].priority && (long)(deadline - bestDeadline) < 0))
+    {
+      // Deferrable work waits for the gate (e.g. link quality); its releases keep merging meanwhile
+      if (gate != nullptr && (job.flags & (SIM7600_JOB_DEFERRABLE | SIM7600_JOB_BULK)) &&
+          !gate(gateCtx, job.flags))
+      {
+        if (!job.held)
+          job.stats.deferred++; // Once per release, not per run() call
+        job.held = true;
+        continue;
+      }
+      best = i;
+      bestDeadline = deadline;
+    }
+  }
+
+  if (best == -1)
+    return false;
+
+  Job &job = jobs[best];
+  job.held = false;
+  bool ok = job.fn(job.ctx);
+  unsigned long finished = clock->millis();
+
+  job.stats.runs++;
+  if (!ok)
+    job.stats.failures++;
+  if (job.deadlineMs != 0 && (long)(finished - (job.release + job.deadlineMs)) > 0)
+  {
+    unsigned long lateness = finished - (job.release + job.deadlineMs);
+    job.stats.deadlineMisses++;
+    if (lateness > job.stats.maxLatenessMs)
+      job.stats.maxLatenessMs = lateness;
+    if (missCallback)
+      missCallback(best, lateness);
+  }
+
+  // The callback may have removed its own job
+  if (job.active)
+  {
+    if (job.periodMs == 0)
+      job.active = false; // One-shot done
+    else
+      advance(job);
+  }
+  return true;
+}
+
+// Public: Time until the next job is released
+unsigned long SIM7600Scheduler::msUntilNextJob(unsigned long *slackMs)
+{
+  unsigned long now = clock->millis();
+  unsigned long soonest = 0xFFFFFFFFUL;
+  int next = -1;
+  for (int i = 0; i < SIM7600_MAX_JOBS; i++)
+  {
+    if (!jobs[i].active || jobs[i].priority < priorityFloor)
+      continue;
+    unsigned long wait = reached(now, jobs[i].release) ? 0 : jobs[i].release - now;
+    if (next == -1 || wait < soonest)
+    {
+      soonest = wait;
+      next = i;
+    }
+  }
+  if (slackMs != nullptr)
+    *slackMs = (next == -1 || jobs[next].deadlineMs == 0) ? SIM7600_NO_DEADLINE : jobs[next].deadlineMs;
+  return soonest;
+}
+
+// Public: Per-job statistics
+const SIM7600JobStats &SIM7600Scheduler::stats(int id)
+{
+  if (id < 0 || id >= SIM7600_MAX_JOBS)
+    return emptyStats;
+  return jobs[id].stats;
+}
@@ -0,0 +1,94 @@
+#ifndef SIM7600SCHEDULER_H  // Prevent multiple inclusions
+#define SIM7600SCHEDULER_H
+
+#include <Arduino.h>
+#include "SIM7600Clock.h"  // Pluggable time source
+// Notes:
+// - Cooperative scheduler for sharing the single modem channel between requests.
+// - Call run() from loop(); it runs at most one due job per call (modem calls block).
+// - Higher priority number = more urgent. Ties go to the earliest deadline.
+
+// Maximum number of jobs in the table (override before including if needed)
+#ifndef SIM7600_MAX_JOBS
+  #define SIM7600_MAX_JOBS 8
+#endif
+
+// Job flags
+#define SIM7600_JOB_DROP_STALE 0x01  // Periodic: skip an instance whose deadline already passed
+#define SIM7600_JOB_DEFERRABLE 0x02  // Ask the gate before running (normal traffic)
+#define SIM7600_JOB_BULK       0x04  // Ask the gate before running (large transfer)
+
+// Slack reported by msUntilNextJob() for a job without a deadline (or no job at all)
+#define SIM7600_NO_DEADLINE 0xFFFFFFFFUL
+
+// Job callback: return true on success, false on failure (counted in stats)
+typedef bool (*SIM7600JobFn)(void* ctx);
+// Gate for deferrable/bulk jobs: return false to hold the job back (flags tell which kind)
+typedef bool (*SIM7600GateFn)(void* ctx, uint8_t flags);
+// Deadline miss callback: job id and how late it finished (ms)
+typedef void (*SIM7600MissFn)(int id, unsigned long latenessMs);
+
+struct SIM7600JobStats {
+  unsigned long runs = 0;            // Times the job ran
+  unsigned long failures = 0;        // Runs that returned false
+  unsigned long deadlineMisses = 0;  // Runs that finished after their deadline (or were dropped)
+  unsigned long merged = 0;          // Periodic releases folded into a later one
+  unsigned long dropped = 0;         // Periodic instances skipped as stale
+  unsigned long deferred = 0;        // Releases the gate held back (each counted once)
+  unsigned long maxLatenessMs = 0;   // Worst finish time past deadline
+};
+
+class SIM7600Scheduler {
+public:
+  SIM7600Scheduler(SIM7600Clock& clk = SIM7600SystemClock);
+
+  // Add a periodic job. deadlineMs = 0 uses the period as deadline.
+  // jitterMs spreads each release by a random 0..jitterMs offset (no drift, anchored to the period).
+  int addPeriodic(SIM7600JobFn fn, void* ctx, unsigned long periodMs, uint8_t priority,
+                  unsigned long deadlineMs = 0, unsigned long jitterMs = 0, uint8_t flags = 0);
+  // Add a one-shot job released after delayMs. deadlineMs = 0 means no deadline.
+  int addOneShot(SIM7600JobFn fn, void* ctx, unsigned long delayMs, uint8_t priority,
+                 unsigned long deadlineMs = 0);
+  bool remove(int id);                   // Remove a job, returns false if id is unknown
+
+  bool run();                            // Run at most one due job, returns true if one ran
+  // Time until the next release (0 if one is due); slackMs gets that job's deadline (SIM7600_NO_DEADLINE = none)
+  unsigned long msUntilNextJob(unsigned long* slackMs = nullptr);
+  const SIM7600JobStats& stats(int id);  // Per-job statistics
+  void setMissCallback(SIM7600MissFn cb) { missCallback = cb; }
+  // Throttle: jobs below this priority are held back (periodic releases merge), e.g. when data runs low
+  void setPriorityFloor(uint8_t priority) { priorityFloor = priority; }
+  // Link-quality gate consulted for SIM7600_JOB_DEFERRABLE / SIM7600_JOB_BULK jobs
+  void setGate(SIM7600GateFn fn, void* ctx) { gate = fn; gateCtx = ctx; }
+
+private:
+  struct Job {
+    SIM7600JobFn fn = nullptr;
+    void* ctx = nullptr;
+    unsigned long periodMs = 0;     // 0 = one-shot
+    unsigned long deadlineMs = 0;   // Relative to release, 0 = none
+    unsigned long jitterMs = 0;
+    unsigned long anchor = 0;       // Nominal release time (without jitter)
+    unsigned long release = 0;      // Actual release time of the pending instance
+    uint8_t priority = 0;
+    uint8_t flags = 0;
+    bool active = false;
+    bool held = false;              // Gate has held the pending release back
+    SIM7600JobStats stats;
+  };
+
+  int allocJob();
+  void catchUp(int id, unsigned long now);  // Merge/drop stale periodic releases
+  void advance(Job& job);                   // Schedule next periodic release
+  static bool reached(unsigned long now, unsigned long t) { return (long)(now - t) >= 0; }
+
+  Job jobs[SIM7600_MAX_JOBS];
+  SIM7600Clock* clock;
+  SIM7600MissFn missCallback = nullptr;
+  uint8_t priorityFloor = 0;
+  SIM7600GateFn gate = nullptr;
+  void* gateCtx = nullptr;
+  SIM7600JobStats emptyStats;
+};
+
+#endif  // End of include guard
@@ -0,0 +1,234 @@
+#include "SIM7600Trace.h"
+
+static const uint8_t traceMagic[3] = {'S', '7', 'T'};
+
+// Constructor
+SIM7600Recorder::SIM7600Recorder(Stream &modem, Print &o, SIM7600Clock &clk) : inner(&modem), out(&o), clock(&clk)
+{
+}
+
+// Public: Write the header and start the time base
+void SIM7600Recorder::begin()
+{
+  out->write(traceMagic, sizeof(traceMagic));
+  out->write((uint8_t)SIM7600_TRACE_VERSION);
+  counters = SIM7600TraceStats();
+  counters.traceBytes = sizeof(traceMagic) + 1;
+  runLen = 0;
+  lastEventUs = clock->micros();
+}
+
+// Public: Byte from the modem
+int SIM7600Recorder::read()
+{
+  int c = inner->read();
+  if (c >= 0)
+  {
+    log(false, (uint8_t)c);
+    counters.rxBytes++;
+  }
+  return c;
+}
+
+// Public: Byte to the modem
+size_t SIM7600Recorder::write(uint8_t c)
+{
+  log(true, c);
+  counters.txBytes++;
+  return inner->write(c);
+}
+
+// Private: Add a byte to the current event, starting a new one on direction change, gap or full buffer
+void SIM7600Recorder::log(bool tx, uint8_t c)
+{
+  unsigned long now = clock->micros();
+  if (runLen > 0 && (tx != runTx || runLen == SIM7600_TRACE_RUN || now - lastByteUs > SIM7600_TRACE_GAP_US))
+  {
+    flushEvent();
+  }
+  if (runLen == 0)
+  {
+    runTx = tx;
+    runStartUs = now;
+  }
+  run[runLen++] = c;
+  lastByteUs = now;
+}
+
+// Private: Write header, varint start delta and data of the current event
+void SIM7600Recorder::flushEvent()
+{
+  if (runLen == 0)
+    return;
+
+  out->write((uint8_t)((runTx ? 0x80 : 0x00) | (runLen - 1)));
+  unsigned long delta = runStartUs - lastEventUs;
+  counters.traceBytes++;
+  do
+  {
+    uint8_t b = delta & 0x7F;
+    delta >>= 7;
+    out->write((uint8_t)(delta ? (b | 0x80) : b));
+    counters.traceBytes++;
+  } while (delta);
+  out->write(run, runLen);
+
+  counters.traceBytes += runLen;
+  counters.events++;
+  lastEventUs = runStartUs;
+  runLen = 0;
+}
+
+// Constructor
+SIM7600Replay::SIM7600Replay(const uint8_t *data, size_t len, SIM7600Clock &clk) : trace(data), traceLen(len), clock(&clk)
+{
+}
+
+// Public: Check the header and start the time base
+bool SIM7600Replay::begin()
+{
+  if (traceLen < sizeof(traceMagic) + 1 || memcmp(trace, traceMagic, sizeof(traceMagic)) != 0 ||
+      trace[sizeof(traceMagic)] != SIM7600_TRACE_VERSION)
+  {
+    SerialMon.println("Error: Not a SIM7600 transcript");
+    cursor = traceLen;
+    return false;
+  }
+  cursor = sizeof(traceMagic) + 1;
+  loaded = false;
+  rxPos = rxEnd = 0;
+  recordedUs = 0;
+  counters = SIM7600ReplayStats();
+  startUs = anchorUs = clock->micros();
+  return true;
+}
+
+// Private: Parse the event header at cursor. False at the end or on a truncated transcript.
+bool SIM7600Replay::loadEvent()
+{
+  if (loaded)
+    return true;
+  if (cursor >= traceLen)
+    return false;
+
+  uint8_t header = trace[cursor];
+  size_t pos = cursor + 1;
+  unsigned long delta = 0;
+  uint8_t shift = 0;
+  uint8_t b;
+  do
+  {
+    if (pos >= traceLen || shift > 28)
+    {
+      cursor = traceLen;
+      return false;
+    }
+    b = trace[pos++];
+    delta |= (unsigned long)(b & 0x7F) << shift;
+    shift += 7;
+  } while (b & 0x80);
+
+  eventTx = header & 0x80;
+  eventLen = (header & 0x7F) + 1;
+  if (pos + eventLen > traceLen)
+  {
+    cursor = traceLen;
+    return false;
+  }
+  eventData = pos;
+  eventPos = 0;
+  recordedUs += delta;
+  eventDueUs = anchorUs + (unsigned long)((uint64_t)delta * scalePercent / 100);
+  loaded = true;
+  return true;
+}
+
+// Private: Move past the loaded event
+void SIM7600Replay::nextEvent()
+{
+  cursor = eventData + eventLen;
+  loaded = false;
+  counters.events++;
+  counters.recordedUs = recordedUs;
+  counters.replayedUs = anchorUs - startUs;
+}
+
+// Private: Make the next RX event readable once its time has come
+void SIM7600Replay::pump()
+{
+  if (rxPos < rxEnd || !loadEvent() || eventTx)
+    return;
+  if ((long)(clock->micros() - eventDueUs) < 0)
+    return;
+
+  rxPos = eventData;
+  rxEnd = eventData + eventLen;
+  counters.rxBytes += eventLen;
+  anchorUs = eventDueUs;
+  nextEvent();
+}
+
+// Private: Count a TX byte the transcript does not have
+void SIM7600Replay::mismatch(size_t offset)
+{
+  counters.mismatches++;
+  if (counters.firstMismatch < 0)
+  {
+    counters.firstMismatch = offset;
+    DEBUG_PRINTLN("Replay mismatch at transcript offset " + String((unsigned long)offset));
+  }
+}
+
+// Public: RX bytes released so far
+int SIM7600Replay::available()
+{
+  pump();
+  return rxEnd - rxPos;
+}
+
+// Public: Next RX byte
+int SIM7600Replay::read()
+{
+  pump();
+  return (rxPos < rxEnd) ? trace[rxPos++] : -1;
+}
+
+// Public: Next RX byte without consuming it
+int SIM7600Replay::peek()
+{
+  pump();
+  return (rxPos < rxEnd) ? trace[rxPos] : -1;
+}
+
+// Public: Compare a byte from the library with the recorded TX
+size_t SIM7600Replay::write(uint8_t c)
+{
+  pump();
+  if (!loadEvent() || !eventTx)
+  {
+    mismatch(cursor); // Sent while the transcript expects RX, or past its end
+    return 1;
+  }
+
+  if (eventPos == 0)
+  {
+    // Lateness of the library compared with the recording
+    unsigned long now = clock->micros();
+    long late = (long)(now - eventDueUs);
+    if (late > counters.maxTxLateUs)
+      counters.maxTxLateUs = late;
+    if (late > 0)
+      counters.totalTxLateUs += late;
+    anchorUs = now;
+  }
+  if (trace[eventData + eventPos] != c)
+  {
+    mismatch(eventData + eventPos);
+  }
+  counters.txBytes++;
+  if (++eventPos == eventLen)
+  {
+    nextEvent();
+  }
+  return 1;
+}
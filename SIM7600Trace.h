@@ -0,0 +1,133 @@
+#ifndef SIM7600TRACE_H  // Prevent multiple inclusions
+#define SIM7600TRACE_H
+
+#include <Arduino.h>
+#include "SIM7600HTTPS.h"  // SerialMon, DEBUG_PRINT and SIM7600Clock
+// Notes:
+// - Record/replay of modem sessions. SIM7600Recorder sits between SIM7600HTTPS and the real
+//   AT port and logs every byte in both directions. SIM7600Replay plays a transcript back as
+//   the AT port, on a SIM7600ReplayClock, so a field trace becomes a repeatable test.
+// - Transcript: "S7T" + version byte, then events of
+//     header (bit 7 = TX, bits 0-6 = length - 1), start time delta in us (varint), data bytes.
+//   Bytes in the same direction are merged into one event unless they are more than
+//   SIM7600_TRACE_GAP_US apart.
+// - RX bytes are stamped when the library reads them, which is how the library saw them.
+
+#define SIM7600_TRACE_VERSION 1
+
+// Bytes held before an event is written (at most 128)
+#ifndef SIM7600_TRACE_RUN
+  #define SIM7600_TRACE_RUN 64
+#endif
+// Gap that starts a new event even in the same direction (us)
+#ifndef SIM7600_TRACE_GAP_US
+  #define SIM7600_TRACE_GAP_US 2000
+#endif
+// Virtual time each clock read costs during replay, so polling loops always advance (us)
+#ifndef SIM7600_REPLAY_TICK_US
+  #define SIM7600_REPLAY_TICK_US 1
+#endif
+
+struct SIM7600TraceStats {
+  unsigned long events = 0;
+  unsigned long txBytes = 0;           // Written by the library
+  unsigned long rxBytes = 0;           // Delivered to the library
+  unsigned long traceBytes = 0;        // Transcript size (recorder only)
+};
+
+struct SIM7600ReplayStats : public SIM7600TraceStats {
+  unsigned long mismatches = 0;        // TX bytes that differ from the transcript, or were not expected
+  long firstMismatch = -1;             // Transcript offset of the first mismatch
+  unsigned long recordedUs = 0;        // Start of the last replayed event in the recording
+  unsigned long replayedUs = 0;        // The same point in the replay
+  long maxTxLateUs = 0;                // Latest TX start compared with the (scaled) recording
+  unsigned long totalTxLateUs = 0;     // Sum of positive TX lateness
+};
+
+// Stream wrapper that records a session into a Print (SD file, serial link to a PC)
+class SIM7600Recorder : public Stream {
+public:
+  SIM7600Recorder(Stream& modem, Print& out, SIM7600Clock& clk = SIM7600SystemClock);
+
+  void begin();                        // Write the transcript header and start the time base
+  void end() { flushEvent(); }         // Write the pending event
+  const SIM7600TraceStats& stats() const { return counters; }
+
+  int available() override { return inner->available(); }
+  int read() override;
+  int peek() override { return inner->peek(); }
+  size_t write(uint8_t c) override;
+  using Print::write;
+  void flush() override { flushEvent(); inner->flush(); }
+
+private:
+  void log(bool tx, uint8_t c);
+  void flushEvent();
+
+  Stream* inner;
+  Print* out;
+  SIM7600Clock* clock;
+  uint8_t run[SIM7600_TRACE_RUN];
+  uint8_t runLen = 0;
+  bool runTx = false;
+  unsigned long runStartUs = 0;
+  unsigned long lastByteUs = 0;
+  unsigned long lastEventUs = 0;
+  SIM7600TraceStats counters;
+};
+
+// Virtual clock for replay: delay() advances time instantly, so a replay runs faster than real time
+class SIM7600ReplayClock : public SIM7600Clock {
+public:
+  unsigned long millis() override { return (unsigned long)(advance() / 1000); }
+  unsigned long micros() override { return (unsigned long)advance(); }
+  void delay(unsigned long ms) override { nowUs += (uint64_t)ms * 1000; }
+
+private:
+  uint64_t advance() { nowUs += SIM7600_REPLAY_TICK_US; return nowUs; }
+  uint64_t nowUs = 0;
+};
+
+// Stream that plays a transcript back as the modem and checks what the library sends
+class SIM7600Replay : public Stream {
+public:
+  SIM7600Replay(const uint8_t* trace, size_t len, SIM7600Clock& clk);
+
+  bool begin();                        // Check the header and start the time base
+  void setTimeScale(uint16_t percent) { scalePercent = percent; }  // 100 = recorded timing, 50 = twice as fast
+  bool complete() const { return cursor >= traceLen && rxPos == rxEnd; }
+  const SIM7600ReplayStats& stats() const { return counters; }
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t c) override;
+  using Print::write;
+  void flush() override {}
+
+private:
+  bool loadEvent();                    // Parse the header of the event at cursor
+  void nextEvent();
+  void pump();                         // Release the next RX event once it is due
+  void mismatch(size_t offset);
+
+  const uint8_t* trace;
+  size_t traceLen;
+  SIM7600Clock* clock;
+  uint16_t scalePercent = 100;
+  size_t cursor = 0;                   // Next event header
+  bool loaded = false;                 // Event at cursor parsed
+  bool eventTx = false;
+  size_t eventData = 0;
+  uint8_t eventLen = 0;
+  uint8_t eventPos = 0;                // TX bytes of the event already matched
+  unsigned long eventDueUs = 0;
+  unsigned long recordedUs = 0;        // Recorded start of the event at cursor
+  unsigned long anchorUs = 0;          // Replay start of the previous event
+  unsigned long startUs = 0;
+  size_t rxPos = 0;                    // RX bytes available to the library
+  size_t rxEnd = 0;
+  SIM7600ReplayStats counters;
+};
+
+#endif  // End of include guard
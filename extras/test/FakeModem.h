@@ -0,0 +1,213 @@
+#ifndef FAKEMODEM_H  // Prevent multiple inclusions
+#define FAKEMODEM_H
+
+#include <Arduino.h>
+#include <deque>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+// Notes:
+// - Scripted SIM7600 for host tests: answers AT commands written to it like the module does.
+// - HTTP: serves `body` for HTTPACTION/HTTPREAD, honours "Range: bytes=N-" in USERDATA with 206,
+//   and can drop the link once after `dropAt` body bytes. AT+HTTPHEAD returns the status line,
+//   Content-Length, Content-Range on a 206 and `headers`.
+// - Replies queued with later() (and +HTTPACTION with deferAction) appear once virtual time reaches them,
+//   so several modems can have requests in flight at once.
+// - `hook` sees every command first; return true to answer it yourself (queue the reply with q()).
+
+class FakeModem : public Stream {
+public:
+  std::string body;                     // HTTP response body
+  int status = 200;
+  bool honorRange = true;               // false = server ignores Range and answers 200
+  long dropAt = -1;                     // Cut one HTTPREAD at this body offset
+  unsigned long actionMs = 300;         // Virtual time between HTTPACTION and its URC
+  long announce = -1;                   // Body length in +HTTPACTION, -1 = body.size()
+  unsigned long linkBytesPerSec = 0;    // > 0 = action time grows with the bytes uploaded and announced
+  bool deferAction = false;             // true = the URC arrives actionMs later instead of advancing the clock
+  std::string headers;                  // Extra response header lines for AT+HTTPHEAD ("Name: value\r\n")
+  std::string userData;                 // Last USERDATA value
+  std::string lastData;                 // Last HTTPDATA payload
+  std::vector<std::string> log;         // Every command received
+  std::function<bool(const std::string&, FakeModem&)> hook;
+
+  void q(const std::string& reply) { rx.insert(rx.end(), reply.begin(), reply.end()); }
+  void later(unsigned long ms, const std::string& reply)  // Queue a reply that arrives ms from now
+  {
+    unsigned long due = millis() + ms;
+    auto it = timed.begin();
+    while (it != timed.end() && (long)(it->first - due) <= 0)
+      ++it;
+    timed.insert(it, std::make_pair(due, reply));
+  }
+  void expectData(long n)  // Take the next n bytes as raw data (after a '>' prompt), then answer OK
+  {
+    dataPending = n;
+    lastData.clear();
+  }
+
+  int available() override
+  {
+    release();
+    return rx.size();
+  }
+  int read() override
+  {
+    release();
+    if (rx.empty())
+      return -1;
+    uint8_t c = rx.front();
+    rx.pop_front();
+    return c;
+  }
+  int peek() override
+  {
+    release();
+    return rx.empty() ? -1 : (uint8_t)rx.front();
+  }
+  size_t write(uint8_t c) override
+  {
+    if (dataPending > 0)
+    {
+      lastData += (char)c;
+      if (--dataPending == 0)
+        q("\r\nOK\r\n");
+      return 1;
+    }
+    if (c == '\r')
+      return 1;
+    if (c != '\n')
+    {
+      line += (char)c;
+      return 1;
+    }
+    std::string cmd = line;
+    line.clear();
+    if (!cmd.empty())
+    {
+      log.push_back(cmd);
+      handle(cmd);
+    }
+    return 1;
+  }
+  using Print::write;
+
+private:
+  static bool starts(const std::string& s, const char* prefix) { return s.compare(0, strlen(prefix), prefix) == 0; }
+
+  void handle(const std::string& cmd)
+  {
+    if (hook && hook(cmd, *this))
+      return;
+    if (starts(cmd, "AT+HTTPPARA=\"USERDATA\""))
+    {
+      userData = cmd;
+      q("\r\nOK\r\n");
+    }
+    else if (cmd == "AT+HTTPTERM")
+    {
+      userData.clear();
+      q("\r\nOK\r\n");
+    }
+    else if (starts(cmd, "AT+HTTPDATA="))
+    {
+      expectData(atol(cmd.c_str() + 12));
+      q("\r\nDOWNLOAD\r\n");
+    }
+    else if (starts(cmd, "AT+HTTPACTION="))
+    {
+      int method = atoi(cmd.c_str() + 14);
+      int code = status;
+      pos = 0;
+      size_t range = userData.find("bytes=");
+      if (range != std::string::npos && honorRange && method == 0)
+      {
+        pos = atol(userData.c_str() + range + 6);
+        code = 206;
+      }
+      long length = (announce >= 0) ? announce : (long)(body.size() - pos);
+      lastCode = code;
+      lastLength = length;
+      std::string urc = "\r\n+HTTPACTION: " + std::to_string(method) + "," + std::to_string(code) + "," +
+                        std::to_string(length) + "\r\n";
+      unsigned long ms = actionMs;
+      if (linkBytesPerSec > 0)
+        ms += (((method == 1 || method == 4) ? lastData.size() : 0) + length) * 1000UL / linkBytesPerSec;
+      q("\r\nOK\r\n");
+      if (deferAction)
+      {
+        later(ms, urc);
+        return;
+      }
+      mockAdvance(ms);
+      q(urc);
+    }
+    else if (cmd == "AT+HTTPHEAD")
+    {
+      std::string head = "HTTP/1.1 " + std::to_string(lastCode) + "\r\nContent-Length: " +
+                         std::to_string(lastLength) + "\r\n";
+      if (lastCode == 206)
+        head += "Content-Range: bytes " + std::to_string(pos) + "-" + std::to_string(body.size() - 1) + "/" +
+                std::to_string(body.size()) + "\r\n";
+      head += headers + "\r\n";
+      q("\r\n+HTTPHEAD: " + std::to_string(head.size()) + "\r\n" + head + "\r\nOK\r\n");
+    }
+    else if (starts(cmd, "AT+HTTPREAD="))
+    {
+      long n = atol(cmd.c_str() + 12);
+      long left = body.size() - pos;
+      if (n > left)
+        n = left;
+      if (n <= 0)
+      {
+        q("\r\nOK\r\n\r\n+HTTPREAD: 0\r\n");
+        return;
+      }
+      q("\r\nOK\r\n\r\n+HTTPREAD: DATA," + std::to_string(n) + "\r\n");
+      if (dropAt >= 0 && (long)pos + n > dropAt)
+      {
+        long k = (dropAt > (long)pos) ? dropAt - pos : 0;
+        q(body.substr(pos, k)); // Link lost mid-chunk
+        pos += k;
+        dropAt = -1;
+        return;
+      }
+      q(body.substr(pos, n));
+      pos += n;
+      mockAdvance(n / 14 + 1); // ~115200 baud
+      q("\r\n+HTTPREAD: 0\r\n");
+    }
+    else
+    {
+      q("\r\nOK\r\n");
+    }
+  }
+
+  void release()  // Move timed replies that are due into rx
+  {
+    while (!timed.empty() && (long)(millis() - timed.front().first) >= 0)
+    {
+      q(timed.front().second);
+      timed.pop_front();
+    }
+  }
+
+  std::deque<char> rx;
+  std::deque<std::pair<unsigned long, std::string> > timed;
+  std::string line;
+  long dataPending = 0;
+  size_t pos = 0;
+  int lastCode = 0;
+  long lastLength = 0;
+};
+
+// Print that collects everything written to it
+class StringSink : public Print {
+public:
+  size_t write(uint8_t c) override { data += (char)c; return 1; }
+  using Print::write;
+  std::string data;
+};
+
+#endif  // End of include guard
@@ -0,0 +1,26 @@
+#ifndef SIM7600TEST_H  // Prevent multiple inclusions
+#define SIM7600TEST_H
+
+#include <Arduino.h>
+#include <stdio.h>
+// Notes:
+// - CHECK() records a failure and carries on; return TEST_RESULT() from main().
+
+static int testFailures = 0;
+static int testChecks = 0;
+
+#define CHECK(cond)                                                   \
+  do                                                                  \
+  {                                                                   \
+    testChecks++;                                                     \
+    if (!(cond))                                                      \
+    {                                                                 \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);          \
+      testFailures++;                                                 \
+    }                                                                 \
+  } while (0)
+
+#define TEST_RESULT() \
+  (printf("%d checks, %d failed\n", testChecks, testFailures), testFailures ? 1 : 0)
+
+#endif  // End of include guard
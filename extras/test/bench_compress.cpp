@@ -0,0 +1,86 @@
+// Compression benchmark: bytes on air and end-to-end time of gzip against plain requests, through
+// FakeModem with a slow link (the action time grows with the bytes sent and received).
+//   make bench && build/bench_compress
+#include <stdio.h>
+#include "FakeModem.h"
+#include "SIM7600HTTPS.h"
+
+#define LINK_BYTES_PER_SEC 2000  // ~16 kbit/s effective, a weak 2G/Cat-M1 link
+#define SERVER_MS 500
+
+// Telemetry batch: one JSON line per charger reading
+static std::string batch(int records)
+{
+  std::string text;
+  char line[128];
+  for (int i = 0; i < records; i++)
+  {
+    snprintf(line, sizeof(line),
+             "{\"station\":\"CS-%02d\",\"ts\":%ld,\"power_kw\":%d.%d,\"energy_wh\":%ld,\"status\":\"charging\"}\n",
+             i % 7, 1760000000L + i * 60L, (i * 37) % 50, (i * 13) % 10, 100000L + (i * 7919L) % 65521);
+    text += line;
+  }
+  return text;
+}
+
+static std::string gzipped(const std::string& in)
+{
+  StringSink out;
+  SIM7600Deflate::gzip((const uint8_t*)in.data(), in.size(), out);
+  return out.data;
+}
+
+struct Run {
+  unsigned long bodyBytes;  // Request + response bodies on the wire
+  unsigned long airBytes;   // Plus estimated HTTP headers and TLS
+  unsigned long ms;         // End to end, virtual
+};
+
+// One POST of body (response: small ack) or one GET of body (gzip if the client asks for it)
+static Run request(const std::string& body, bool post, bool compress)
+{
+  FakeModem modem;
+  modem.linkBytesPerSec = LINK_BYTES_PER_SEC;
+  modem.actionMs = SERVER_MS;
+  modem.hook = [&body, post](const std::string& cmd, FakeModem& m) {
+    if (!post && cmd.compare(0, 14, "AT+HTTPACTION=") == 0)
+      m.body = (m.userData.find("Accept-Encoding: gzip") != std::string::npos) ? gzipped(body) : body;
+    return false;
+  };
+  modem.body = post ? "{\"ack\":1}" : "";
+  SIM7600HTTPS http(modem);
+  http.setCompression(compress);
+  String response;
+  unsigned long start = millis();
+  bool ok = http.httpInit("https://example.com", "/batch", post ? SIM7600_HTTP_POST : SIM7600_HTTP_GET) &&
+            (post ? http.httpPost(body.c_str(), response) : http.httpGet(response));
+  Run r;
+  r.ms = millis() - start;
+  const SIM7600EndpointUsage* u = http.endpointUsage("/batch");
+  r.bodyBytes = u ? u->txBytes + u->rxBytes : 0;
+  r.airBytes = u ? r.bodyBytes + u->overheadBytes : 0;
+  if (!ok || (!post && response.s != body))
+    printf("request failed\n");
+  return r;
+}
+
+int main()
+{
+  printf("Link %d B/s, server %d ms. Bytes on air include estimated headers and a TLS handshake.\n",
+         LINK_BYTES_PER_SEC, SERVER_MS);
+  printf("%-5s %6s | %-20s | %-20s | %s\n", "", "raw B", "plain: body/air/ms", "gzip: body/air/ms", "saved air, time");
+  const int sizes[] = {1, 5, 20, 80};
+  for (int post = 1; post >= 0; post--)
+  {
+    for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+      std::string body = batch(sizes[i]);
+      Run plain = request(body, post, false);
+      Run gz = request(body, post, true);
+      printf("%-5s %6u | %5lu %6lu %6lu | %5lu %6lu %6lu | %4.0f%% %4.0f%%\n", post ? "POST" : "GET",
+             (unsigned)body.size(), plain.bodyBytes, plain.airBytes, plain.ms, gz.bodyBytes, gz.airBytes, gz.ms,
+             100.0 * (1.0 - (double)gz.airBytes / plain.airBytes), 100.0 * (1.0 - (double)gz.ms / plain.ms));
+    }
+  }
+  return 0;
+}
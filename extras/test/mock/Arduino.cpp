@@ -0,0 +1,39 @@
+#include "Arduino.h"
+
+HardwareSerial Serial, Serial1, Serial2;
+
+static uint64_t nowUs = 0;
+static int pins[64];
+static bool pinsWritten[64];
+
+unsigned long millis() { return (unsigned long)(nowUs / 1000); }
+unsigned long micros() { return (unsigned long)nowUs; }
+void delay(unsigned long ms) { nowUs += (uint64_t)ms * 1000; }
+void delayMicroseconds(unsigned int us) { nowUs += us; }
+void mockAdvance(unsigned long ms) { nowUs += (uint64_t)ms * 1000; }
+void mockSetMicros(uint64_t us) { nowUs = us; }
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  if (pin < 64)
+  {
+    pins[pin] = value;
+    pinsWritten[pin] = true;
+  }
+}
+int digitalRead(uint8_t pin) { return (pin < 64) ? pins[pin] : LOW; }
+int mockPinState(uint8_t pin) { return (pin < 64 && pinsWritten[pin]) ? pins[pin] : -1; }
+
+long random(long max) { return max > 0 ? rand() % max : 0; }
+long random(long min, long max) { return max > min ? min + rand() % (max - min) : min; }
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  static int echo = -1;
+  if (echo == -1)
+    echo = getenv("MOCK_SERIAL") != nullptr && strcmp(getenv("MOCK_SERIAL"), "1") == 0;
+  if (echo)
+    putchar(c);
+  return 1;
+}
@@ -0,0 +1,189 @@
+#ifndef MOCK_ARDUINO_H  // Prevent multiple inclusions
+#define MOCK_ARDUINO_H
+// Notes:
+// - Minimal Arduino core for running the library on a PC (host tests only).
+// - Time is virtual: millis()/micros() only move when delay() or mockAdvance() is called,
+//   so every test is deterministic.
+// - Serial output is discarded unless MOCK_SERIAL=1 is set in the environment.
+
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cctype>
+#include <cmath>
+#include <algorithm>  // Standard headers the tests use come before the min/max macros
+#include <deque>
+#include <functional>
+#include <vector>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define DEC 10
+#define HEX 16
+
+#ifndef min
+  #define min(a, b) ((a) < (b) ? (a) : (b))
+  #define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+using std::isnan;
+using std::isinf;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+long random(long max);
+long random(long min, long max);
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// Test helpers
+void mockAdvance(unsigned long ms);      // Move virtual time forward
+void mockSetMicros(uint64_t us);         // Jump virtual time (e.g. to test wraparound)
+int mockPinState(uint8_t pin);           // Last digitalWrite() value, -1 if never written
+
+class String {
+public:
+  String(const char* c = "") : s(c ? c : "") {}
+  String(const std::string& x) : s(x) {}
+  String(char c) : s(1, c) {}
+  String(int v) : s(std::to_string(v)) {}
+  String(unsigned int v) : s(std::to_string(v)) {}
+  String(long v) : s(std::to_string(v)) {}
+  String(unsigned long v) : s(std::to_string(v)) {}
+  String(float v, unsigned char decimals = 2) { format(v, decimals); }
+  String(double v, unsigned char decimals = 2) { format(v, decimals); }
+  String(unsigned char v, int base) : s(base == HEX ? hex(v) : std::to_string(v)) {}
+  String(int v, int base) : s(base == HEX ? hex((unsigned)v) : std::to_string(v)) {}
+  String(unsigned long v, int base) : s(base == HEX ? hex(v) : std::to_string(v)) {}
+
+  unsigned int length() const { return s.size(); }
+  const char* c_str() const { return s.c_str(); }
+  bool reserve(unsigned int n) { s.reserve(n); return true; }
+  char charAt(unsigned int i) const { return i < s.size() ? s[i] : 0; }
+  char operator[](unsigned int i) const { return s[i]; }
+
+  int indexOf(const String& x, unsigned int from = 0) const { return pos(s.find(x.s, from)); }
+  int indexOf(char x, unsigned int from = 0) const { return pos(s.find(x, from)); }
+  int lastIndexOf(char x) const { return pos(s.rfind(x)); }
+  String substring(unsigned int a) const { return a > s.size() ? String("") : String(s.substr(a)); }
+  String substring(unsigned int a, unsigned int b) const {
+    if (a > b) std::swap(a, b);
+    return a > s.size() ? String("") : String(s.substr(a, b - a));
+  }
+  bool startsWith(const String& x) const { return s.compare(0, x.s.size(), x.s) == 0; }
+  bool endsWith(const String& x) const {
+    return s.size() >= x.s.size() && s.compare(s.size() - x.s.size(), x.s.size(), x.s) == 0;
+  }
+  bool equalsIgnoreCase(const String& x) const {
+    if (s.size() != x.s.size()) return false;
+    for (size_t i = 0; i < s.size(); i++)
+      if (tolower(s[i]) != tolower(x.s[i])) return false;
+    return true;
+  }
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return atof(s.c_str()); }
+
+  void trim() {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == std::string::npos) { s = ""; return; }
+    s = s.substr(a, s.find_last_not_of(" \t\r\n") - a + 1);
+  }
+  void toLowerCase() { for (auto& c : s) c = tolower(c); }
+  void toUpperCase() { for (auto& c : s) c = toupper(c); }
+  void remove(unsigned int i) { if (i < s.size()) s.erase(i); }
+  void remove(unsigned int i, unsigned int n) { if (i < s.size()) s.erase(i, n); }
+  void replace(const String& a, const String& b) {
+    for (size_t p = 0; (p = s.find(a.s, p)) != std::string::npos; p += b.s.size()) s.replace(p, a.s.size(), b.s);
+  }
+  bool concat(const String& x) { s += x.s; return true; }
+  bool concat(char c) { s += c; return true; }
+  bool concat(const char* c, unsigned int n) { s.append(c, n); return true; }
+
+  String& operator+=(const String& x) { s += x.s; return *this; }
+  String& operator+=(const char* x) { s += x; return *this; }
+  String& operator+=(char c) { s += c; return *this; }
+  String& operator+=(int v) { s += std::to_string(v); return *this; }
+  String& operator+=(unsigned long v) { s += std::to_string(v); return *this; }
+  bool operator==(const String& x) const { return s == x.s; }
+  bool operator!=(const String& x) const { return s != x.s; }
+  bool operator==(const char* x) const { return s == x; }
+  bool operator!=(const char* x) const { return s != x; }
+
+  std::string s;
+
+private:
+  static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+  static std::string hex(unsigned long v) { char b[24]; snprintf(b, sizeof(b), "%lx", v); return b; }
+  void format(double v, unsigned char d) { char b[64]; snprintf(b, sizeof(b), "%.*f", d, v); s = b; }
+};
+
+inline String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+inline String operator+(const String& a, const char* b) { return String(a.s + b); }
+inline String operator+(const char* a, const String& b) { return String(std::string(a) + b.s); }
+inline String operator+(const String& a, char b) { return String(a.s + b); }
+inline String operator+(const String& a, int b) { return String(a.s + std::to_string(b)); }
+inline String operator+(const String& a, long b) { return String(a.s + std::to_string(b)); }
+inline String operator+(const String& a, unsigned long b) { return String(a.s + std::to_string(b)); }
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* b, size_t n) { size_t k = 0; while (n--) k += write(*b++); return k; }
+  size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+  size_t write(const char* b, size_t n) { return write((const uint8_t*)b, n); }
+  virtual void flush() {}
+  virtual int availableForWrite() { return 0; }
+
+  size_t print(const String& x) { return write(x.c_str()); }
+  size_t print(const char* x) { return write(x); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long v, int base = DEC) { return print(base == HEX ? String((unsigned long)v, HEX) : String(v)); }
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned long v, int base = DEC) { return print(String(v, base)); }
+  size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(double v, int decimals = 2) { return print(String(v, (unsigned char)decimals)); }
+  size_t println() { return write("\r\n"); }
+  template <class T> size_t println(const T& x) { size_t n = print(x); return n + println(); }
+  size_t println(long v, int base) { size_t n = print(v, base); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  void setTimeout(unsigned long) {}
+  size_t readBytes(char* b, size_t n) { size_t k = 0; while (k < n && available()) b[k++] = read(); return k; }
+  size_t readBytes(uint8_t* b, size_t n) { return readBytes((char*)b, n); }
+};
+
+// Serial ports: no input, output to stdout when MOCK_SERIAL=1
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  size_t write(uint8_t c) override;
+  using Print::write;
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif  // End of include guard
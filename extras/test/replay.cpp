@@ -0,0 +1,86 @@
+// Replays a recorded modem session against the library and reports mismatches and latency.
+//   replay [transcript] [scale%]   replay (default data/sample_session.s7t at 100%)
+//   replay --record out.s7t        record the same session against FakeModem (regenerates the sample)
+// The session below must be the one that was recorded; edit both together.
+#include <stdio.h>
+#include <string.h>
+#include "FakeModem.h"
+#include "SIM7600Trace.h"
+
+static const char* server = "https://example.com";
+
+// Requests of the recorded session
+static bool runSession(SIM7600HTTPS& modem)
+{
+  String response;
+  bool ok = modem.httpInit(server, "/api/status") && modem.httpGet(response);
+  ok = ok && modem.httpInit(server, "/api/telemetry", SIM7600_HTTP_POST) &&
+       modem.httpPost("{\"temp\":21.5,\"hum\":40}", response);
+  return ok;
+}
+
+static int record(const char* path)
+{
+  FakeModem fake;
+  fake.body = "{\"ok\":true}";
+  StringSink sink;
+  SIM7600Recorder recorder(fake, sink);
+  SIM7600HTTPS modem(recorder);
+  recorder.begin();
+  bool ok = runSession(modem);
+  recorder.end();
+
+  FILE* f = fopen(path, "wb");
+  if (f == nullptr || fwrite(sink.data.data(), 1, sink.data.size(), f) != sink.data.size())
+  {
+    printf("Cannot write %s\n", path);
+    return 1;
+  }
+  fclose(f);
+  printf("%s: session %s, %lu events, %lu bytes\n", path, ok ? "ok" : "FAILED", recorder.stats().events,
+         recorder.stats().traceBytes);
+  return ok ? 0 : 1;
+}
+
+static int replay(const char* path, uint16_t scale)
+{
+  FILE* f = fopen(path, "rb");
+  if (f == nullptr)
+  {
+    printf("Cannot open %s\n", path);
+    return 1;
+  }
+  std::vector<uint8_t> trace;
+  int c;
+  while ((c = fgetc(f)) != EOF)
+    trace.push_back((uint8_t)c);
+  fclose(f);
+
+  SIM7600ReplayClock clock;
+  SIM7600Replay session(trace.data(), trace.size(), clock);
+  SIM7600HTTPS modem(session, clock);
+  session.setTimeScale(scale);
+  if (!session.begin())
+    return 1;
+  bool ok = runSession(modem);
+
+  const SIM7600ReplayStats& s = session.stats();
+  printf("%s at %u%%: session %s, transcript %s\n", path, scale, ok ? "ok" : "FAILED",
+         session.complete() ? "complete" : "NOT complete");
+  printf("  events %lu, tx %lu bytes, rx %lu bytes\n", s.events, s.txBytes, s.rxBytes);
+  printf("  mismatches %lu", s.mismatches);
+  if (s.firstMismatch >= 0)
+    printf(" (first at transcript offset %ld)", s.firstMismatch);
+  printf("\n  recorded %lu us, replayed %lu us\n", s.recordedUs, s.replayedUs);
+  printf("  tx late: max %ld us, total %lu us\n", s.maxTxLateUs, s.totalTxLateUs);
+  return (ok && session.complete() && s.mismatches == 0) ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc >= 3 && strcmp(argv[1], "--record") == 0)
+    return record(argv[2]);
+  const char* path = (argc >= 2) ? argv[1] : "data/sample_session.s7t";
+  uint16_t scale = (argc >= 3) ? atoi(argv[2]) : 100;
+  return replay(path, scale);
+}
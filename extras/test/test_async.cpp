@@ -0,0 +1,102 @@
+// beginHttpAction/pollHttp: no wait for +HTTPACTION, body delivery, truncated bodies, timeouts
+#include "SIM7600Test.h"
+#include "FakeModem.h"
+#include "SIM7600HTTPS.h"
+
+static std::string text(size_t n)
+{
+  std::string s;
+  for (size_t i = 0; i < n; i++)
+    s += (char)('a' + i % 26);
+  return s;
+}
+
+// Poll in 10 ms steps of virtual time until the request settles
+static int settle(SIM7600HTTPS& http, unsigned long& polls)
+{
+  int state;
+  polls = 0;
+  while ((state = http.pollHttp()) == SIM7600_PENDING)
+  {
+    polls++;
+    mockAdvance(10);
+  }
+  return state;
+}
+
+static void testGet()
+{
+  FakeModem modem;
+  modem.body = text(1000);
+  modem.deferAction = true;
+  modem.actionMs = 2000;
+  SIM7600HTTPS http(modem);
+  CHECK(http.httpInit("https://example.com", "/a"));
+  unsigned long start = millis();
+  CHECK(http.beginHttpAction(SIM7600_HTTP_GET));
+  CHECK(millis() - start < 100);                  // Did not wait for the server
+  CHECK(!http.beginHttpAction(SIM7600_HTTP_GET)); // One request at a time
+  CHECK(http.pollHttp() == SIM7600_PENDING);
+
+  unsigned long polls;
+  CHECK(settle(http, polls) == SIM7600_DONE);
+  CHECK(polls >= 200);                            // Pending for the whole action time
+  CHECK(http.lastStatus() == 200);
+  CHECK(std::string(http.takeHttpResponse().c_str()) == modem.body);
+  CHECK(http.pollHttp() == SIM7600_FAILED);       // Nothing in progress
+}
+
+static void testPost()
+{
+  FakeModem modem;
+  modem.body = "{\"ok\":true}";
+  SIM7600HTTPS http(modem);
+  CHECK(http.httpInit("https://example.com", "/t", SIM7600_HTTP_POST));
+  CHECK(http.beginHttpAction(SIM7600_HTTP_POST, "{\"temp\":21.5}"));
+  CHECK(modem.lastData == "{\"temp\":21.5}");
+  unsigned long polls;
+  CHECK(settle(http, polls) == SIM7600_DONE);
+  CHECK(http.takeHttpResponse() == "{\"ok\":true}");
+}
+
+// +HTTPREAD: 0 before the announced length is a failure, not a short success
+static void testTruncated()
+{
+  FakeModem modem;
+  modem.body = text(256);
+  modem.announce = 1000;
+  SIM7600HTTPS http(modem);
+  CHECK(http.httpInit("https://example.com", "/a"));
+  CHECK(http.beginHttpAction(SIM7600_HTTP_GET));
+  unsigned long polls;
+  CHECK(settle(http, polls) == SIM7600_FAILED);
+  CHECK(http.takeHttpResponse().length() == 0);
+}
+
+static void testTimeout()
+{
+  FakeModem modem;
+  modem.hook = [](const std::string& cmd, FakeModem& m) {
+    if (cmd.compare(0, 14, "AT+HTTPACTION=") != 0)
+      return false;
+    m.q("\r\nOK\r\n"); // Server never answers
+    return true;
+  };
+  SIM7600HTTPS http(modem);
+  CHECK(http.httpInit("https://example.com", "/a"));
+  CHECK(http.beginHttpAction(SIM7600_HTTP_GET));
+  unsigned long start = millis();
+  unsigned long polls;
+  CHECK(settle(http, polls) == SIM7600_FAILED);
+  CHECK(millis() - start >= 12500 && millis() - start < 13000);
+  CHECK(http.beginHttpAction(SIM7600_HTTP_GET)); // Free again after the failure
+}
+
+int main()
+{
+  testGet();
+  testPost();
+  testTruncated();
+  testTimeout();
+  return TEST_RESULT();
+}
@@ -0,0 +1,82 @@
+// SIM7600Coro.h (C++20): two tasks sharing one modem in FIFO order, failure, body delivery
+#include "SIM7600Test.h"
+#include "FakeModem.h"
+#include "SIM7600Coro.h"
+
+#ifndef SIM7600_HAS_COROUTINES
+#error "test_coro needs a C++20 compiler with coroutine support"
+#endif
+
+static std::vector<std::string> order;  // Resources in the order their requests completed
+static std::vector<SIM7600CoResult> results;
+static int finished = 0;
+
+static SIM7600Task twoGets(SIM7600CoModem& co)
+{
+  SIM7600CoResult a = co_await co.get("https://example.com", "/a1");
+  order.push_back("a1");
+  results.push_back(a);
+  SIM7600CoResult b = co_await co.get("https://example.com", "/a2"); // Queues behind task B
+  order.push_back("a2");
+  results.push_back(b);
+  finished++;
+}
+
+static SIM7600Task onePost(SIM7600CoModem& co)
+{
+  SIM7600CoResult r = co_await co.post("https://example.com", "/b", "{\"n\":1}");
+  order.push_back("b");
+  results.push_back(r);
+  co_await co.sleep(1000);
+  finished++;
+}
+
+// Each resource gets its own body; /a2 announces more than it delivers
+static bool serve(const std::string& cmd, FakeModem& m)
+{
+  if (cmd.compare(0, 18, "AT+HTTPPARA=\"URL\",") != 0)
+    return false;
+  std::string url = cmd.substr(cmd.find("/", 27));
+  m.body = "body of " + url.substr(0, url.size() - 1);
+  m.announce = (url == "/a2\"") ? 500 : -1;
+  m.q("\r\nOK\r\n");
+  return true;
+}
+
+static void testTwoTasks()
+{
+  FakeModem modem;
+  modem.deferAction = true;
+  modem.actionMs = 1500;
+  modem.hook = serve;
+  SIM7600HTTPS http(modem);
+  SIM7600Executor exec;
+  SIM7600CoModem co(http, exec);
+
+  unsigned long start = millis();
+  twoGets(co);
+  onePost(co);
+  CHECK(millis() - start < 100); // Starting the tasks does not wait for the server
+  while (exec.poll())
+    mockAdvance(10);
+
+  CHECK(finished == 2);
+  CHECK(order.size() == 3);
+  if (order.size() == 3)
+  {
+    CHECK(order[0] == "a1");
+    CHECK(order[1] == "b");  // FIFO: the second get waits for the post queued before it
+    CHECK(order[2] == "a2");
+    CHECK(results[0].ok && results[0].status == 200 && results[0].body == "body of /a1");
+    CHECK(results[1].ok && results[1].body == "body of /b");
+    CHECK(!results[2].ok && results[2].body.length() == 0); // Body ended short
+  }
+  CHECK(modem.lastData == "{\"n\":1}");
+  CHECK(millis() - start >= 3 * 1500); // One modem: the three actions ran one after another
+}
+
+int main()
+{
+  testTwoTasks();
+  return TEST_RESULT();
+}
@@ -0,0 +1,119 @@
+// gzip: compressor/inflater round-trips, a zlib-made stream with dynamic Huffman codes, corrupt input
+#include "SIM7600Test.h"
+#include "FakeModem.h"
+#include "SIM7600Deflate.h"
+#include "SIM7600CRC32.h"
+
+// Python: gzip.compress(<telemetryText(40)>, 9, mtime=0) - dynamic Huffman block
+static const uint8_t zlibGzip[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0xd5, 0x3d, 0x0a, 0xc2, 0x50,
+  0x10, 0x45, 0xe1, 0xde, 0x65, 0xbc, 0x5a, 0x87, 0xbc, 0x79, 0x2f, 0x51, 0xd3, 0xba, 0x04, 0x17,
+  0x20, 0x22, 0xa2, 0x22, 0xa8, 0xf8, 0x83, 0x85, 0xb8, 0x77, 0xc5, 0xee, 0x0e, 0x08, 0x87, 0xd4,
+  0xc9, 0xad, 0xce, 0x37, 0xc9, 0x2b, 0xdd, 0xee, 0xeb, 0xfb, 0xe1, 0x7c, 0x4a, 0x7d, 0x5a, 0x2c,
+  0x27, 0x4d, 0x93, 0xc6, 0xe9, 0x72, 0x7e, 0x6e, 0xaf, 0xab, 0xe3, 0x33, 0xf5, 0x8d, 0x35, 0xe3,
+  0xdf, 0x0b, 0x8f, 0xdb, 0xf7, 0xf9, 0x66, 0xbf, 0xbe, 0xee, 0x0e, 0xa7, 0x5d, 0x7a, 0x8f, 0x5e,
+  0x61, 0x96, 0x65, 0x56, 0x2c, 0xb3, 0x99, 0xcb, 0xac, 0x33, 0x67, 0xb3, 0x22, 0xb3, 0xb9, 0x15,
+  0x36, 0xab, 0x32, 0xcb, 0x6e, 0x95, 0xed, 0x5a, 0xdd, 0xb5, 0xd6, 0xb2, 0x5d, 0xa7, 0xbb, 0x99,
+  0x75, 0x6c, 0xa7, 0x0d, 0x3c, 0xdb, 0x74, 0x48, 0x04, 0xaf, 0x36, 0x1b, 0x52, 0xc1, 0xa7, 0x36,
+  0x1f, 0x92, 0xa1, 0x60, 0x2c, 0xda, 0xa1, 0x60, 0x2d, 0xda, 0xa1, 0x60, 0x2e, 0xda, 0xa1, 0x60,
+  0x2f, 0xda, 0xa1, 0x62, 0x2f, 0xda, 0xa1, 0x62, 0x2f, 0xda, 0xa1, 0x62, 0x2f, 0xda, 0x01, 0x73,
+  0xd1, 0x0c, 0x58, 0x8b, 0x56, 0xc0, 0x58, 0xc2, 0x31, 0x60, 0x2c, 0x1a, 0x21, 0x63, 0x2c, 0x1a,
+  0x21, 0x63, 0x2c, 0x1a, 0x21, 0x63, 0x2c, 0x1a, 0xc1, 0x31, 0x16, 0xad, 0xe0, 0x18, 0x8b, 0x66,
+  0x70, 0x8c, 0x25, 0x1c, 0x03, 0xd6, 0xa2, 0x1d, 0x0a, 0xe6, 0x12, 0xfe, 0x0c, 0xd8, 0x4b, 0x38,
+  0x06, 0xec, 0x45, 0x3b, 0x54, 0xec, 0x25, 0x5c, 0x03, 0xf6, 0xa2, 0x1d, 0x2a, 0xf6, 0xa2, 0x1d,
+  0x30, 0x17, 0xcd, 0x80, 0xb5, 0x68, 0x05, 0x8c, 0x25, 0x1c, 0x03, 0xc6, 0x12, 0xbe, 0x48, 0x18,
+  0x4b, 0xf8, 0x43, 0xff, 0xc5, 0xf2, 0x01, 0x40, 0x5d, 0x87, 0xb0, 0xb6, 0x08, 0x00, 0x00,};
+
+struct Source
+{
+  const std::string* data;
+  size_t pos;
+};
+
+static int pull(void* ctx)
+{
+  Source* src = (Source*)ctx;
+  return (src->pos < src->data->size()) ? (uint8_t)(*src->data)[src->pos++] : -1;
+}
+
+static bool gunzip(const std::string& in, std::string& out)
+{
+  Source src = {&in, 0};
+  String text;
+  bool ok = SIM7600Inflate::gunzip(pull, &src, text);
+  out = text.s;
+  return ok;
+}
+
+static std::string telemetryText(int records)
+{
+  std::string text;
+  char line[96];
+  for (int i = 0; i < records; i++)
+  {
+    snprintf(line, sizeof(line), "{\"station\":\"CS-%02d\",\"power_kw\":%d.%d,\"status\":\"charging\"}\n", i % 7,
+             i * 3 % 50, i % 10);
+    text += line;
+  }
+  return text;
+}
+
+// Compress, check the dry-run length matches, inflate and compare
+static void roundTrip(const std::string& in, const char* name, bool expectSmaller)
+{
+  StringSink out;
+  SIM7600ByteCounter counter;
+  size_t written = SIM7600Deflate::gzip((const uint8_t*)in.data(), in.size(), out);
+  SIM7600Deflate::gzip((const uint8_t*)in.data(), in.size(), counter);
+
+  std::string back;
+  bool ok = gunzip(out.data, back);
+  if (!ok || back != in)
+    printf("  round trip failed: %s (%zu bytes)\n", name, in.size());
+  CHECK(ok);
+  CHECK(back == in);
+  CHECK(written == out.data.size());
+  CHECK(counter.count == out.data.size());
+  CHECK(SIM7600Inflate::isGzip((const uint8_t*)out.data.data(), out.data.size()));
+  if (expectSmaller)
+    CHECK(out.data.size() < in.size() / 2);
+}
+
+int main()
+{
+  // CRC-32 check value
+  SIM7600CRC32 crc;
+  crc.update((const uint8_t*)"123456789", 9);
+  CHECK(crc.value() == 0xCBF43926UL);
+
+  roundTrip("", "empty", false);
+  roundTrip("a", "one byte", false);
+  roundTrip(telemetryText(40), "telemetry", true);
+  roundTrip(std::string(5000, 'x'), "long run", true);  // Maximum-length matches
+  std::string binary;
+  srand(7);
+  for (int i = 0; i < 5000; i++)
+    binary += (char)(rand() & 0xFF);
+  roundTrip(binary, "random", false);
+  std::string far;  // Matches near the edge of the window
+  for (int i = 0; i < 6; i++)
+    far += binary.substr(0, SIM7600_DEFLATE_WINDOW - 3) + "|";
+  roundTrip(far, "window edge", false);
+
+  // Stream from zlib (dynamic Huffman codes)
+  std::string zlibStream((const char*)zlibGzip, sizeof(zlibGzip));
+  std::string text;
+  CHECK(gunzip(zlibStream, text));
+  CHECK(text == telemetryText(40));
+
+  // Corruption is reported, not returned as data
+  std::string badCrc = zlibStream;
+  badCrc[badCrc.size() - 6] ^= 0x01; // CRC32 trailer
+  CHECK(!gunzip(badCrc, text));
+  std::string truncated = zlibStream.substr(0, zlibStream.size() / 2);
+  CHECK(!gunzip(truncated, text));
+  std::string notGzip = "{\"plain\":true}";
+  CHECK(!gunzip(notGzip, text));
+
+  return TEST_RESULT();
+}
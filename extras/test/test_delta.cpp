@@ -0,0 +1,63 @@
+// Delta encoder: integer overloads, full/delta records, ack and resync parsing
+#include "SIM7600Test.h"
+#include "SIM7600Delta.h"
+
+static void testTypes()
+{
+  SIM7600DeltaEncoder enc;
+  int i = -3;
+  unsigned int u = 40000U;
+  unsigned long ul = 4000000000UL;
+  CHECK(enc.set("i", i));
+  CHECK(enc.set("u", u));
+  CHECK(enc.set("ul", ul));
+  CHECK(enc.set("l", 7L));
+  CHECK(enc.set("f", 1.25f));
+  CHECK(enc.set("b", true));
+  CHECK(enc.set("s", "a\"b"));
+  String body = enc.encode();
+  CHECK(body == "{\"seq\":1,\"full\":true,\"i\":-3,\"u\":40000,\"ul\":4000000000,\"l\":7,\"f\":1.25,\"b\":true,"
+                "\"s\":\"a\\\"b\"}");
+  CHECK(enc.stats().fullBytes == body.length());
+}
+
+static void testDelta()
+{
+  SIM7600DeltaEncoder enc("dev");
+  enc.set("a", 1);
+  enc.set("b", "x");
+  enc.encode();
+  CHECK(enc.handleResponse("{\"ack\":1}"));
+  enc.set("a", 2);
+  enc.remove("b");
+  CHECK(enc.encode() == "{\"seq\":2,\"stream\":\"dev\",\"base\":1,\"a\":2,\"b\":null}");
+  CHECK(enc.handleResponse("{\"ack\":1}"));  // Older ack: base stays at 1
+  CHECK(enc.encode() == "{\"seq\":3,\"stream\":\"dev\",\"base\":1,\"a\":2,\"b\":null}");
+  CHECK(enc.handleResponse("{\"ack\":3}"));
+  CHECK(enc.encode() == "{\"seq\":4,\"stream\":\"dev\",\"base\":3}");
+}
+
+static void testResync()
+{
+  SIM7600DeltaEncoder enc;
+  enc.set("a", 1);
+  enc.encode();
+  enc.handleResponse("{\"ack\":1}");
+
+  // "resync" is false; the true belongs to another key
+  CHECK(!enc.handleResponse("{\"resync\":false,\"stored\":true}"));
+  CHECK(enc.encode() == "{\"seq\":2,\"base\":1}");
+  CHECK(enc.stats().resyncs == 0);
+
+  CHECK(enc.handleResponse("{\"resync\" : true}"));
+  CHECK(enc.stats().resyncs == 1);
+  CHECK(enc.encode() == "{\"seq\":3,\"full\":true,\"a\":1}");
+}
+
+int main()
+{
+  testTypes();
+  testDelta();
+  testResync();
+  return TEST_RESULT();
+}
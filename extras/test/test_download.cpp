@@ -0,0 +1,143 @@
+// httpDownload: Range resume after a dropped link, fallback when the server ignores Range, CRC,
+// Content-Range check
+#include "SIM7600Test.h"
+#include "FakeModem.h"
+#include "SIM7600HTTPS.h"
+
+static std::string firmware()
+{
+  std::string body;
+  srand(3);
+  for (int i = 0; i < 20000; i++)
+    body += (char)(rand() & 0xFF);
+  return body;
+}
+
+static uint32_t crcOf(const std::string& data, size_t from = 0)
+{
+  SIM7600CRC32 crc;
+  crc.update((const uint8_t*)data.data() + from, data.size() - from);
+  return crc.value();
+}
+
+static void testClean(const std::string& body)
+{
+  FakeModem modem;
+  modem.body = body;
+  SIM7600HTTPS http(modem);
+  StringSink sink;
+  SIM7600DownloadStats stats;
+  CHECK(http.httpDownload("https://example.com", "/fw.bin", sink, stats));
+  CHECK(sink.data == body);
+  CHECK(stats.resumes == 0);
+  CHECK(stats.bytesRefetched == 0);
+  CHECK(stats.crc32 == crcOf(body));
+  CHECK(stats.status == 200);
+}
+
+static void testResume(const std::string& body, bool honorRange)
+{
+  FakeModem modem;
+  modem.body = body;
+  modem.dropAt = 12345;
+  modem.honorRange = honorRange;
+  SIM7600HTTPS http(modem);
+  StringSink sink;
+  SIM7600DownloadStats stats;
+  CHECK(http.httpDownload("https://example.com", "/fw.bin", sink, stats));
+  CHECK(sink.data == body); // No byte written twice or lost
+  CHECK(stats.bytesWritten == body.size());
+  CHECK(stats.resumes == 1);
+  CHECK(stats.crc32 == crcOf(body));
+
+  // Resume point is the last whole chunk before the drop
+  unsigned long confirmed = 12345 / SIM7600_DOWNLOAD_CHUNK * SIM7600_DOWNLOAD_CHUNK;
+  bool rangeSent = false;
+  for (size_t i = 0; i < modem.log.size(); i++)
+  {
+    if (modem.log[i].find("Range: bytes=" + std::to_string(confirmed) + "-") != std::string::npos)
+      rangeSent = true;
+  }
+  CHECK(rangeSent);
+  if (honorRange)
+  {
+    CHECK(stats.status == 206);
+    CHECK(stats.bytesRefetched == 12345 - confirmed); // Partial chunk lost in the drop
+  }
+  else
+  {
+    CHECK(stats.status == 200);
+    CHECK(stats.bytesRefetched >= confirmed); // Whole body fetched again, already written part skipped
+  }
+}
+
+static void testOffset(const std::string& body)
+{
+  FakeModem modem;
+  modem.body = body;
+  SIM7600HTTPS http(modem);
+  StringSink sink;
+  SIM7600DownloadStats stats;
+  CHECK(http.httpDownload("https://example.com", "/fw.bin", sink, stats, 8192));
+  CHECK(sink.data == body.substr(8192)); // Continues an earlier download
+  CHECK(stats.crc32 == crcOf(body, 8192));
+
+  // With the first call's CRC as seed, crc32 covers the whole file
+  CHECK(http.httpDownload("https://example.com", "/fw.bin", sink, stats, 8192, 3, crcOf(body.substr(0, 8192))));
+  CHECK(stats.crc32 == crcOf(body));
+}
+
+static void testWrongRange(const std::string& body)
+{
+  FakeModem modem;
+  modem.body = body;
+  modem.dropAt = 12345;
+  modem.hook = [&body](const std::string& cmd, FakeModem& m) {
+    if (cmd != "AT+HTTPHEAD")
+      return false;
+    std::string head = "HTTP/1.1 206\r\nContent-Range: bytes 0-" + std::to_string(body.size() - 1) + "/" +
+                       std::to_string(body.size()) + "\r\n\r\n"; // Resumed from the start instead
+    m.q("\r\n+HTTPHEAD: " + std::to_string(head.size()) + "\r\n" + head + "\r\nOK\r\n");
+    return true;
+  };
+  SIM7600HTTPS http(modem);
+  StringSink sink;
+  SIM7600DownloadStats stats;
+  CHECK(!http.httpDownload("https://example.com", "/fw.bin", sink, stats));
+  unsigned long confirmed = 12345 / SIM7600_DOWNLOAD_CHUNK * SIM7600_DOWNLOAD_CHUNK;
+  CHECK(sink.data == body.substr(0, confirmed)); // Nothing appended at the wrong place
+  CHECK(stats.status == 206);
+}
+
+static void testGiveUp(const std::string& body)
+{
+  FakeModem modem;
+  modem.body = body;
+  modem.hook = [](const std::string& cmd, FakeModem& m) {
+    if (cmd.compare(0, 14, "AT+HTTPACTION=") != 0)
+      return false;
+    m.q("\r\nOK\r\n"); // Server never answers
+    return true;
+  };
+  SIM7600HTTPS http(modem);
+  StringSink sink;
+  SIM7600DownloadStats stats;
+  CHECK(!http.httpDownload("https://example.com", "/fw.bin", sink, stats, 0, 1));
+  CHECK(stats.resumes == 1);
+  CHECK(sink.data.empty());
+
+  CHECK(!http.httpDownload("https://example.com", "/fw.bin", sink, stats, 0, 255)); // Counter does not wrap
+  CHECK(stats.resumes == 255);
+}
+
+int main()
+{
+  std::string body = firmware();
+  testClean(body);
+  testResume(body, true);
+  testResume(body, false);
+  testOffset(body);
+  testWrongRange(body);
+  testGiveUp(body);
+  return TEST_RESULT();
+}
@@ -0,0 +1,146 @@
+// httpInit: session reuse, URL and Content-Type set once per HTTP session; custom headers and USERDATA,
+// HEAD with response headers, PATCH override
+#include "SIM7600Test.h"
+#include "FakeModem.h"
+#include "SIM7600HTTPS.h"
+
+static int count(const FakeModem& modem, const std::string& prefix)
+{
+  int n = 0;
+  for (size_t i = 0; i < modem.log.size(); i++)
+  {
+    if (modem.log[i].compare(0, prefix.size(), prefix) == 0)
+      n++;
+  }
+  return n;
+}
+
+static void testContentType()
+{
+  FakeModem modem;
+  modem.body = "{\"ok\":true}";
+  SIM7600HTTPS http(modem);
+  const std::string content = "AT+HTTPPARA=\"CONTENT\"";
+  String response;
+
+  CHECK(http.httpInit("https://example.com", "/api") && http.httpGet(response));
+  CHECK(count(modem, content) == 0); // GET has no body
+  CHECK(http.httpInit("https://example.com", "/api", SIM7600_HTTP_POST) && http.httpPost("{}", response));
+  CHECK(count(modem, content) == 1); // Same resource, but the first request with a body
+  CHECK(count(modem, "AT+HTTPINIT") == 1);
+  CHECK(http.httpInit("https://example.com", "/api", SIM7600_HTTP_POST) && http.httpPost("{}", response));
+  CHECK(count(modem, content) == 1); // Still set in this session
+
+  CHECK(http.httpInit("https://example.com", "/other", SIM7600_HTTP_PUT) &&
+        http.httpRequest(SIM7600_HTTP_PUT, "{}", response));
+  CHECK(count(modem, "AT+HTTPINIT") == 2);
+  CHECK(count(modem, content) == 2); // New session needs it again
+}
+
+static void testAddHeader()
+{
+  FakeModem modem;
+  SIM7600HTTPS http(modem);
+  CHECK(!http.addHeader("X-Bad", "a\"b"));     // Would end the quoted USERDATA string
+  CHECK(!http.addHeader("X-Bad", "a\r\nHost: x")); // Header injection
+  for (int i = 0; i < SIM7600_MAX_HEADERS; i++)
+    CHECK(http.addHeader(("X-H" + std::to_string(i)).c_str(), "1"));
+  CHECK(!http.addHeader("X-More", "1"));        // Full
+  CHECK(http.addHeader("x-h0", "2"));           // Same name, any case: replaced
+  http.clearHeaders();
+  CHECK(http.addHeader("X-More", "1"));
+}
+
+static void testUserData()
+{
+  FakeModem modem;
+  modem.body = "ok";
+  SIM7600HTTPS http(modem);
+  String response;
+  CHECK(http.addHeader("Authorization", "Bearer t0k"));
+  CHECK(http.httpInit("https://example.com", "/api") && http.httpGet(response));
+  CHECK(modem.userData == "AT+HTTPPARA=\"USERDATA\",\"Authorization: Bearer t0k\"");
+  CHECK(http.httpGet(response));
+  CHECK(count(modem, "AT+HTTPPARA=\"USERDATA\"") == 1); // Unchanged: not sent again
+
+  // Custom headers first, then Accept-Encoding, then the request's own
+  http.setCompression(true);
+  std::string body(300, 'a');
+  CHECK(http.httpInit("https://example.com", "/api", SIM7600_HTTP_POST) && http.httpPost(body.c_str(), response));
+  CHECK(modem.userData == "AT+HTTPPARA=\"USERDATA\",\"Authorization: Bearer t0k\\r\\nAccept-Encoding: gzip\\r\\n"
+                          "Content-Encoding: gzip\"");
+
+  // Too long for the module: refused before HTTPACTION
+  CHECK(http.addHeader("X-Long", std::string(SIM7600_MAX_USERDATA, 'x').c_str()));
+  int actions = count(modem, "AT+HTTPACTION");
+  CHECK(!http.httpGet(response));
+  CHECK(count(modem, "AT+HTTPACTION") == actions);
+}
+
+static void testHead()
+{
+  FakeModem modem;
+  modem.body = std::string(1500, 'h');
+  modem.status = 503;
+  modem.headers = "ETag: \"v42\"\r\nRetry-After: 120\r\n";
+  SIM7600HTTPS http(modem);
+  SIM7600HttpResponse info;
+  CHECK(http.httpInit("https://example.com", "/health") && http.httpHead(info));
+  CHECK(modem.log.back() == "AT+HTTPHEAD");
+  CHECK(count(modem, "AT+HTTPACTION=2") == 1);
+  CHECK(count(modem, "AT+HTTPREAD") == 0); // No body read
+  CHECK(info.status == 503);
+  CHECK(info.contentLength == 1500);
+  CHECK(info.etag == "\"v42\"");
+  CHECK(info.retryAfterSec == 120);
+
+  modem.headers = "Retry-After: Wed, 21 Oct 2026 07:28:00 GMT\r\n";
+  CHECK(http.httpHead(info));
+  CHECK(info.retryAfterSec == -1); // HTTP-date form not parsed
+  CHECK(info.etag == "");
+}
+
+static void testPatch()
+{
+  FakeModem modem;
+  modem.body = "ok";
+  SIM7600HTTPS http(modem);
+  String response;
+  CHECK(http.httpInit("https://example.com", "/item/1", SIM7600_HTTP_PATCH) &&
+        http.httpRequest(SIM7600_HTTP_PATCH, "{\"n\":2}", response));
+  CHECK(count(modem, "AT+HTTPACTION=1") == 1); // POST on the module
+  CHECK(modem.userData.find("X-HTTP-Method-Override: PATCH") != std::string::npos);
+  CHECK(modem.lastData == "{\"n\":2}");
+
+  CHECK(http.httpPost("{}", response));
+  CHECK(modem.userData.find("X-HTTP-Method-Override") == std::string::npos); // Only on the PATCH
+}
+
+// Health check every minute for a day: HEAD against GET of a 1.5 KB status page
+static void testHealthCheckBytes()
+{
+  FakeModem modem;
+  modem.body = std::string(1500, 's');
+  SIM7600HTTPS http(modem);
+  String response;
+  SIM7600HttpResponse info;
+  CHECK(http.httpInit("https://example.com", "/health") && http.httpGet(response));
+  unsigned long getBytes = http.totalDataUsage();
+  http.resetDataUsage();
+  CHECK(http.httpHead(info) && info.status == 200);
+  unsigned long headBytes = http.totalDataUsage();
+  printf("Health check: GET %lu B, HEAD %lu B on air, %lu B saved per check, %lu KB per day at 1/min\n", getBytes,
+         headBytes, getBytes - headBytes, (getBytes - headBytes) * 1440 / 1024);
+  CHECK(getBytes - headBytes == 1500); // The body; headers and TLS stay
+}
+
+int main()
+{
+  testContentType();
+  testAddHeader();
+  testUserData();
+  testHead();
+  testPatch();
+  testHealthCheckBytes();
+  return TEST_RESULT();
+}
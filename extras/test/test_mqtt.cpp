@@ -0,0 +1,185 @@
+// MQTT: TLS verification setup, late result URCs, messages arriving during commands,
+// latency and bytes on air against HTTPS POSTs
+#include "SIM7600Test.h"
+#include "FakeModem.h"
+#include "SIM7600MQTT.h"
+
+static int received = 0;
+static std::string lastPayload;
+static void onMessage(const String& topic, const String& payload)
+{
+  received++;
+  lastPayload = payload.s;
+}
+
+static std::string incoming(const std::string& topic, const std::string& payload)
+{
+  return "\r\n+CMQTTRXSTART: 0," + std::to_string(topic.size()) + "," + std::to_string(payload.size()) +
+         "\r\n+CMQTTRXTOPIC: 0," + std::to_string(topic.size()) + "\r\n" + topic + "\r\n+CMQTTRXPAYLOAD: 0," +
+         std::to_string(payload.size()) + "\r\n" + payload + "\r\n+CMQTTRXEND: 0\r\n";
+}
+
+static bool starts(const std::string& s, const char* prefix) { return s.compare(0, strlen(prefix), prefix) == 0; }
+
+static bool sent(const FakeModem& modem, const char* prefix)
+{
+  for (size_t i = 0; i < modem.log.size(); i++)
+  {
+    if (starts(modem.log[i], prefix))
+      return true;
+  }
+  return false;
+}
+
+// Broker behaviour shared by the tests. pubResults: URCs for successive AT+CMQTTPUB ("" = none)
+static std::vector<std::string> pubResults;
+static size_t pubCount = 0;
+static std::string lateUrc; // Queued with the next TOPIC prompt
+
+static bool broker(const std::string& cmd, FakeModem& m)
+{
+  if (cmd == "AT+CMQTTSTART")
+    m.q("\r\nOK\r\n\r\n+CMQTTSTART: 0\r\n");
+  else if (starts(cmd, "AT+CMQTTCONNECT"))
+    m.q("\r\nOK\r\n\r\n+CMQTTCONNECT: 0,0\r\n");
+  else if (starts(cmd, "AT+CMQTTTOPIC") || starts(cmd, "AT+CMQTTPAYLOAD") || starts(cmd, "AT+CMQTTSUB=") ||
+           starts(cmd, "AT+CCERTDOWN"))
+  {
+    m.expectData(atol(cmd.c_str() + cmd.rfind(',') + 1));
+    if (starts(cmd, "AT+CMQTTSUB="))
+      m.expectData(atol(cmd.c_str() + cmd.find(',') + 1));
+    m.q("\r\n>");
+    if (starts(cmd, "AT+CMQTTTOPIC") && !lateUrc.empty())
+    {
+      m.q(lateUrc);
+      lateUrc.clear();
+    }
+  }
+  else if (starts(cmd, "AT+CMQTTPUB"))
+  {
+    m.q("\r\nOK\r\n");
+    m.q(incoming("cmd/dev1", "during publish"));
+    if (pubCount < pubResults.size())
+      m.q(pubResults[pubCount]);
+    pubCount++;
+  }
+  else
+    return false;
+  return true;
+}
+
+static void testTlsNeedsCA()
+{
+  FakeModem modem;
+  modem.hook = broker;
+  SIM7600HTTPS http(modem);
+  SIM7600MQTT mqtt(http);
+  CHECK(!mqtt.connect("broker.example.com", 8883, "dev1"));
+  CHECK(!sent(modem, "AT+CMQTTSTART")); // Refused before touching the module
+
+  mqtt.setInsecure();
+  CHECK(mqtt.connect("broker.example.com", 8883, "dev1"));
+  CHECK(sent(modem, "AT+CSSLCFG=\"authmode\",0,0"));
+}
+
+static void testTlsVerifies()
+{
+  FakeModem modem;
+  modem.hook = broker;
+  SIM7600HTTPS http(modem);
+  SIM7600MQTT mqtt(http);
+  CHECK(mqtt.loadCACert("ca.pem", "-----BEGIN CERTIFICATE-----\nMIIB\n-----END CERTIFICATE-----\n"));
+  CHECK(modem.lastData.find("BEGIN CERTIFICATE") != std::string::npos);
+  CHECK(mqtt.connect("broker.example.com", 8883, "dev1"));
+  CHECK(sent(modem, "AT+CSSLCFG=\"cacert\",0,\"ca.pem\""));
+  CHECK(sent(modem, "AT+CSSLCFG=\"authmode\",0,1"));
+  CHECK(!sent(modem, "AT+CSSLCFG=\"authmode\",0,0"));
+}
+
+static void testLateUrc()
+{
+  FakeModem modem;
+  modem.hook = broker;
+  SIM7600HTTPS http(modem);
+  SIM7600MQTT mqtt(http);
+  mqtt.onMessage(onMessage);
+  received = 0;
+  pubCount = 0;
+  pubResults.clear();
+  pubResults.push_back("");                      // First publish: broker never confirms in time
+  pubResults.push_back("\r\n+CMQTTPUB: 0,11\r\n"); // Second publish fails
+  pubResults.push_back("\r\n+CMQTTPUB: 0,0\r\n");  // Third succeeds
+  CHECK(mqtt.connect("broker.example.com", 1883, "dev1", false));
+
+  CHECK(!mqtt.publish("telemetry/dev1", "{\"n\":1}", 1));
+  lateUrc = "\r\n+CMQTTPUB: 0,0\r\n"; // The first publish's confirmation turns up late
+  CHECK(!mqtt.publish("telemetry/dev1", "{\"n\":2}", 1)); // Not completed by the stale URC
+  CHECK(mqtt.publish("telemetry/dev1", "{\"n\":3}", 1));
+  CHECK(mqtt.stats().published == 1);
+  CHECK(mqtt.stats().publishFailures == 2);
+  CHECK(received == 3); // Messages arriving during the publishes are still delivered
+  CHECK(lastPayload == "during publish");
+}
+
+// Same records over MQTT (one TLS connection) and HTTPS POSTs (new connection each) on a link with
+// RTT_MS round trips: a new TLS connection costs 3 round trips before the answer, a QoS 1 publish one
+#define RTT_MS 600
+#define RECORDS 20
+
+static void testVsHttp()
+{
+  const char* record = "{\"temp\":21.5,\"hum\":40,\"volt\":12.61}";
+
+  FakeModem mqttModem;
+  mqttModem.hook = [](const std::string& cmd, FakeModem& m) {
+    if (starts(cmd, "AT+CMQTTCONNECT"))
+    {
+      mockAdvance(3 * RTT_MS); // TCP + TLS handshake + CONNECT/CONNACK
+      m.q("\r\nOK\r\n\r\n+CMQTTCONNECT: 0,0\r\n");
+      return true;
+    }
+    if (starts(cmd, "AT+CMQTTPUB"))
+    {
+      m.q("\r\nOK\r\n");
+      m.later(RTT_MS, "\r\n+CMQTTPUB: 0,0\r\n"); // PUBACK
+      return true;
+    }
+    return broker(cmd, m);
+  };
+  SIM7600HTTPS mqttHttp(mqttModem);
+  SIM7600MQTT mqtt(mqttHttp);
+  mqtt.setInsecure();
+  unsigned long start = millis();
+  CHECK(mqtt.connect("broker.example.com", 8883, "dev1"));
+  for (int i = 0; i < RECORDS; i++)
+    CHECK(mqtt.publish("telemetry/dev1", record, 1));
+  unsigned long mqttMs = millis() - start;
+  unsigned long mqttBytes = mqtt.stats().wireBytes + SIM7600_EST_TLS_HANDSHAKE; // Plus the one handshake
+
+  FakeModem httpModem;
+  httpModem.actionMs = 3 * RTT_MS; // TCP + TLS handshake + request/response
+  httpModem.body = "{\"ok\":1}";
+  SIM7600HTTPS http(httpModem);
+  String response;
+  start = millis();
+  for (int i = 0; i < RECORDS; i++)
+    CHECK(http.httpInit("https://example.com", "/telemetry", SIM7600_HTTP_POST) && http.httpPost(record, response));
+  unsigned long httpMs = millis() - start;
+  unsigned long httpBytes = http.totalDataUsage();
+
+  printf("%d records, RTT %d ms: MQTT %lu ms (%lu ms per publish), %lu B; HTTPS %lu ms, %lu B\n", RECORDS, RTT_MS,
+         mqttMs, mqtt.stats().totalLatencyMs / mqtt.stats().published, mqttBytes, httpMs, httpBytes);
+  CHECK(mqtt.stats().published == RECORDS);
+  CHECK(mqtt.stats().totalLatencyMs / RECORDS < 2 * RTT_MS);
+  CHECK(mqttMs * 2 < httpMs);
+  CHECK(mqttBytes * 5 < httpBytes);
+}
+
+int main()
+{
+  testTlsNeedsCA();
+  testTlsVerifies();
+  testLateUrc();
+  testVsHttp();
+  return TEST_RESULT();
+}
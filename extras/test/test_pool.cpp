@@ -0,0 +1,172 @@
+// SIM7600Pool: round-robin, overlapping requests on several modems, failover and backoff
+#include "SIM7600Test.h"
+#include "FakeModem.h"
+#include "SIM7600Pool.h"
+
+static const char* server = "https://example.com";
+
+static int actions(const FakeModem& modem)
+{
+  int n = 0;
+  for (size_t i = 0; i < modem.log.size(); i++)
+  {
+    if (modem.log[i].compare(0, 14, "AT+HTTPACTION=") == 0)
+      n++;
+  }
+  return n;
+}
+
+// Server that never answers on this modem
+static bool silent(const std::string& cmd, FakeModem& m)
+{
+  if (cmd.compare(0, 14, "AT+HTTPACTION=") != 0)
+    return false;
+  m.q("\r\nOK\r\n");
+  return true;
+}
+
+static void drain(SIM7600Pool& pool)
+{
+  while (pool.poll())
+    mockAdvance(10);
+}
+
+struct Bench {
+  FakeModem fake[3];
+  SIM7600HTTPS* http[3];
+  SIM7600Pool pool;
+  Bench()
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      fake[i].body = "from modem " + std::to_string(i);
+      fake[i].deferAction = true;
+      fake[i].actionMs = 2000;
+      http[i] = new SIM7600HTTPS(fake[i]);
+      pool.add(*http[i]);
+    }
+  }
+  ~Bench()
+  {
+    for (int i = 0; i < 3; i++)
+      delete http[i];
+  }
+};
+
+static void testRoundRobin()
+{
+  Bench b;
+  unsigned long start = millis();
+  int t[3];
+  for (int i = 0; i < 3; i++)
+    t[i] = b.pool.begin(server, "/a");
+  CHECK(t[0] >= 0 && t[1] >= 0 && t[2] >= 0);
+  CHECK(b.pool.begin(server, "/a") == -1); // All three busy
+  for (int i = 0; i < 3; i++)
+    CHECK(actions(b.fake[i]) == 1);
+  CHECK(b.pool.result(t[0]) == SIM7600_PENDING);
+
+  drain(b.pool);
+  CHECK(millis() - start < 2 * 2000); // The three server waits overlapped
+  for (int i = 0; i < 3; i++)
+  {
+    CHECK(b.pool.result(t[i]) == SIM7600_DONE);
+    CHECK(b.pool.status(t[i]) == 200);
+    CHECK(b.pool.takeResponse(t[i]) == String(("from modem " + std::to_string(i)).c_str()));
+    CHECK(b.pool.requests(i) == 1);
+  }
+  CHECK(b.pool.result(t[0]) == SIM7600_FAILED); // Ticket freed
+}
+
+// Nine requests: three modems in parallel against one after another with the blocking call
+static void testThroughput()
+{
+  Bench b;
+  unsigned long start = millis();
+  int started = 0, done = 0;
+  while (done < 9)
+  {
+    while (started < 9 && b.pool.begin(server, "/a") >= 0)
+      started++;
+    b.pool.poll();
+    mockAdvance(10);
+    for (int i = 0; i < SIM7600_MAX_MODEMS; i++)
+    {
+      if (b.pool.result(i) == SIM7600_DONE)
+      {
+        b.pool.takeResponse(i);
+        done++;
+      }
+    }
+  }
+  unsigned long parallelMs = millis() - start;
+
+  start = millis();
+  String response;
+  for (int i = 0; i < 9; i++)
+    CHECK(b.pool.httpGet(server, "/a", response));
+  unsigned long serialMs = millis() - start;
+  printf("9 requests, 2 s server time each: %lu ms on 3 modems with begin/poll, %lu ms blocking\n", parallelMs,
+         serialMs);
+  CHECK(parallelMs * 2 < serialMs);
+}
+
+static void testFailover()
+{
+  Bench b;
+  b.pool.setRetryAfter(30000);
+  b.fake[0].hook = silent;
+  int t = b.pool.begin(server, "/a");
+  CHECK(actions(b.fake[0]) == 1);
+  drain(b.pool);
+  CHECK(b.pool.result(t) == SIM7600_DONE); // Moved to modem 1 after the timeout
+  CHECK(b.pool.takeResponse(t) == "from modem 1");
+  CHECK(b.pool.failures(0) == 1);
+  CHECK(b.pool.healthyCount() == 2);
+
+  // Backoff: modem 0 is skipped until retryAfter has passed
+  for (int i = 0; i < 4; i++)
+  {
+    t = b.pool.begin(server, "/a");
+    drain(b.pool);
+    CHECK(b.pool.result(t) == SIM7600_DONE);
+    b.pool.takeResponse(t);
+  }
+  CHECK(actions(b.fake[0]) == 1);
+  CHECK(b.pool.requests(1) + b.pool.requests(2) == 5);
+
+  mockAdvance(30000);
+  CHECK(b.pool.healthyCount() == 3);
+  b.fake[0].hook = nullptr;
+  for (int i = 0; i < 3; i++)
+  {
+    t = b.pool.begin(server, "/a");
+    drain(b.pool);
+    b.pool.takeResponse(t);
+  }
+  CHECK(actions(b.fake[0]) == 2); // Back in rotation
+  CHECK(b.pool.failures(0) == 1);
+}
+
+static void testAllFail()
+{
+  Bench b;
+  for (int i = 0; i < 3; i++)
+    b.fake[i].hook = silent;
+  int t = b.pool.begin(server, "/a");
+  drain(b.pool);
+  CHECK(b.pool.result(t) == SIM7600_FAILED);
+  CHECK(b.pool.healthyCount() == 0);
+  CHECK(b.pool.begin(server, "/a") == -1); // Everyone backing off
+  String response;
+  CHECK(!b.pool.httpGet(server, "/a", response));
+}
+
+int main()
+{
+  testRoundRobin();
+  testThroughput();
+  testFailover();
+  testAllFail();
+  return TEST_RESULT();
+}
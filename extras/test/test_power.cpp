@@ -0,0 +1,148 @@
+// Power: CSCLK only with DTR, mode choice, early wake that survives a wake twice as slow as estimated,
+// charge without DTR, requests waking the module
+#include "SIM7600Test.h"
+#include "FakeModem.h"
+#include "SIM7600Power.h"
+#include "SIM7600Scheduler.h"
+
+static bool sent(const FakeModem& modem, const char* cmd)
+{
+  for (size_t i = 0; i < modem.log.size(); i++)
+  {
+    if (modem.log[i] == cmd)
+      return true;
+  }
+  return false;
+}
+
+static void testBegin()
+{
+  FakeModem modem;
+  SIM7600HTTPS http(modem);
+  SIM7600Power noDtr(http);
+  CHECK(noDtr.begin());
+  CHECK(!sent(modem, "AT+CSCLK=1"));
+
+  SIM7600Power withDtr(http, 7);
+  CHECK(withDtr.begin());
+  CHECK(sent(modem, "AT+CSCLK=1"));
+  CHECK(mockPinState(7) == LOW);
+}
+
+static void testChooseMode()
+{
+  FakeModem modem;
+  SIM7600HTTPS http(modem);
+  SIM7600Power power(http, 7);
+  SIM7600Power noDtr(http);
+  CHECK(power.chooseMode(500) == SIM7600_SLEEP_NONE);  // Below every minimum idle
+  CHECK(power.chooseMode(5000) == SIM7600_SLEEP_DTR);
+  CHECK(noDtr.chooseMode(5000) == SIM7600_SLEEP_NONE); // eDRX not worth it yet, DTR unavailable
+  CHECK(power.chooseMode(25000, SIM7600_NO_DEADLINE) == SIM7600_SLEEP_EDRX);
+  CHECK(power.chooseMode(120000, 1000) == SIM7600_SLEEP_PSM); // Wake starts 5 s early
+  power.setWakeCost(SIM7600_SLEEP_PSM, 70000);
+  CHECK(power.chooseMode(120000, 0) == SIM7600_SLEEP_EDRX);   // 140 s lead does not fit
+  CHECK(power.chooseMode(120000, 30000) == SIM7600_SLEEP_PSM); // 110 s lead does
+  power.setMaxMode(SIM7600_SLEEP_DTR);
+  CHECK(power.chooseMode(120000, SIM7600_NO_DEADLINE) == SIM7600_SLEEP_DTR);
+}
+
+// Sleep until a release 120 s away, then wake while the module takes wakeMs to answer
+static long lateness(unsigned long slackMs, unsigned long wakeMs)
+{
+  FakeModem modem;
+  bool slept = false;
+  modem.hook = [&](const std::string& cmd, FakeModem& m) {
+    if (cmd != "AT" || !slept)
+      return false;
+    slept = false;
+    mockAdvance(wakeMs); // First byte only after wakeMs
+    m.q("\r\nOK\r\n");
+    return true;
+  };
+  SIM7600HTTPS http(modem);
+  SIM7600Power power(http, 7);
+  power.begin();
+  unsigned long release = millis() + 120000;
+  power.manage(120000, slackMs);
+  CHECK(power.currentMode() == SIM7600_SLEEP_PSM);
+  slept = true;
+  while (!power.awake())
+  {
+    mockAdvance(100);
+    power.manage(release - millis(), slackMs);
+  }
+  return (long)(millis() - release);
+}
+
+static void testEarlyWake()
+{
+  CHECK(lateness(1000, 6000) <= 1000);  // Twice as slow: late by no more than the slack
+  CHECK(lateness(0, 6000) <= 0);        // No slack: still on time
+  CHECK(lateness(SIM7600_NO_DEADLINE, 3000) <= 0); // No deadline: wakes one cost early
+}
+
+static void testNoDtrCharge()
+{
+  FakeModem modem;
+  SIM7600HTTPS http(modem);
+  SIM7600Power power(http);
+  CHECK(power.begin());
+  power.manage(200000, SIM7600_NO_DEADLINE);
+  CHECK(power.currentMode() == SIM7600_SLEEP_PSM); // Radio-only sleep still saves paging and TAU
+  mockAdvance(100000);
+  unsigned long charge = power.estimatedChargeUAh();
+  CHECK(charge >= 100000UL * SIM7600_CURRENT_NO_DTR_UA / 3600000UL); // Not the PSM figure: UART awake
+  CHECK(charge < 100000UL * SIM7600_CURRENT_AWAKE_UA / 3600000UL);
+}
+
+static void testWakeOnRequest()
+{
+  FakeModem modem;
+  modem.body = "ok";
+  SIM7600HTTPS http(modem);
+  SIM7600Power power(http, 7);
+  CHECK(power.begin());
+  String response;
+  CHECK(http.httpInit("https://example.com", "/a"));
+
+  CHECK(power.sleep(SIM7600_SLEEP_DTR));
+  CHECK(mockPinState(7) == HIGH);
+  CHECK(http.httpGet(response) && response == "ok"); // Woken by the request
+  CHECK(power.awake() && mockPinState(7) == LOW);
+
+  CHECK(power.sleep(SIM7600_SLEEP_PSM));
+  CHECK(!http.httpGet(response)); // HTTP service gone after PSM
+  CHECK(power.awake());
+  CHECK(http.httpInit("https://example.com", "/a") && http.httpGet(response) && response == "ok");
+
+  CHECK(power.sleep(SIM7600_SLEEP_EDRX));
+  CHECK(http.beginHttpAction(SIM7600_HTTP_GET));
+  CHECK(power.awake());
+  while (http.pollHttp() == SIM7600_PENDING)
+    mockAdvance(10);
+  CHECK(http.takeHttpResponse() == "ok");
+  CHECK(power.stats().wakeFailures == 0);
+}
+
+static void testNoDeadlineSlack()
+{
+  SIM7600Scheduler s;
+  unsigned long slack = 0;
+  s.msUntilNextJob(&slack);
+  CHECK(slack == SIM7600_NO_DEADLINE); // No jobs
+  s.addOneShot([](void*) { return true; }, nullptr, 5000, 1);
+  CHECK(s.msUntilNextJob(&slack) == 5000);
+  CHECK(slack == SIM7600_NO_DEADLINE); // One-shot without a deadline
+}
+
+int main()
+{
+  testBegin();
+  testChooseMode();
+  testEarlyWake();
+  testNoDtrCharge();
+  testWakeOnRequest();
+  testNoDeadlineSlack();
+  return TEST_RESULT();
+}
@@ -0,0 +1,198 @@
+// Radio metrics: CSQ/CPSI parsing, default send policy thresholds, and a scripted signal trace
+// comparing timeouts and goodput with and without the send gate
+#include "SIM7600Test.h"
+#include "FakeModem.h"
+#include "SIM7600HTTPS.h"
+
+static int csq = 20;
+static std::string cpsi;
+static int csqReads = 0;
+
+static bool radioModem(const std::string& cmd, FakeModem& m)
+{
+  if (cmd == "AT+CSQ")
+  {
+    csqReads++;
+    m.q("\r\n+CSQ: " + std::to_string(csq) + ",99\r\n\r\nOK\r\n");
+    return true;
+  }
+  if (cmd == "AT+CPSI?")
+  {
+    m.q("\r\n" + cpsi + "\r\n\r\nOK\r\n");
+    return true;
+  }
+  return false;
+}
+
+static void testParse()
+{
+  FakeModem modem;
+  modem.hook = radioModem;
+  SIM7600HTTPS http(modem);
+  const SIM7600RadioMetrics& r = http.radioMetrics();
+  CHECK(!r.valid);
+
+  csq = 21;
+  cpsi = "+CPSI: LTE,Online,460-11,0x5A1E,187214081,257,EUTRAN-BAND3,1825,5,5,-94,-850,-545,15";
+  CHECK(http.refreshRadioMetrics(true));
+  CHECK(r.valid && r.lte);
+  CHECK(r.rssi == 21);
+  CHECK(r.rsrq == -9);
+  CHECK(r.rsrp == -85);
+  CHECK(r.sinr == 15);
+
+  csq = 14;
+  cpsi = "+CPSI: WCDMA,Online,001-01,0xA2A7,25701,WCDMA IMT 2000,10737,,,-84,-7,-3";
+  CHECK(http.refreshRadioMetrics(true));
+  CHECK(!r.lte && r.rssi == 14);
+  CHECK(r.rsrp == 0 && r.rsrq == 0 && r.sinr == 0); // LTE values from before are gone
+
+  csq = 9;
+  cpsi = "+CPSI: GSM,Online,460-00,0x182d,12401,27 EGSM 900,-64,2110,42-42";
+  CHECK(http.refreshRadioMetrics(true));
+  CHECK(!r.lte && r.rssi == 9);
+
+  csq = 99;
+  cpsi = "+CPSI: NO SERVICE,Online";
+  CHECK(http.refreshRadioMetrics(true));
+  CHECK(!r.lte && r.rssi == 99);
+  CHECK(!http.linkAllows(SIM7600_TRANSFER_NORMAL));
+  CHECK(http.linkAllows(SIM7600_TRANSFER_URGENT));
+
+  // Cached for SIM7600_RADIO_REFRESH_MS
+  int reads = csqReads;
+  CHECK(http.refreshRadioMetrics());
+  CHECK(csqReads == reads);
+  mockAdvance(SIM7600_RADIO_REFRESH_MS);
+  CHECK(http.refreshRadioMetrics());
+  CHECK(csqReads == reads + 1);
+}
+
+static SIM7600RadioMetrics metrics(int rssi, bool lte, int rsrp)
+{
+  SIM7600RadioMetrics r;
+  r.valid = true;
+  r.rssi = rssi;
+  r.lte = lte;
+  r.rsrp = rsrp;
+  return r;
+}
+
+static void testPolicy()
+{
+  SIM7600RadioMetrics unknown;
+  CHECK(SIM7600HTTPS::defaultSendPolicy(unknown, SIM7600_TRANSFER_BULK, 0)); // Nothing to judge by
+
+  CHECK(!SIM7600HTTPS::defaultSendPolicy(metrics(99, false, 0), SIM7600_TRANSFER_NORMAL, 0));
+  CHECK(SIM7600HTTPS::defaultSendPolicy(metrics(99, false, 0), SIM7600_TRANSFER_URGENT, 0));
+  CHECK(!SIM7600HTTPS::defaultSendPolicy(metrics(SIM7600_NORMAL_MIN_RSSI - 1, false, 0), SIM7600_TRANSFER_NORMAL, 0));
+  CHECK(SIM7600HTTPS::defaultSendPolicy(metrics(SIM7600_NORMAL_MIN_RSSI, false, 0), SIM7600_TRANSFER_NORMAL, 0));
+
+  CHECK(!SIM7600HTTPS::defaultSendPolicy(metrics(SIM7600_BULK_MIN_RSSI - 1, false, 0), SIM7600_TRANSFER_BULK, 0));
+  CHECK(SIM7600HTTPS::defaultSendPolicy(metrics(SIM7600_BULK_MIN_RSSI, false, 0), SIM7600_TRANSFER_BULK, 0));
+  CHECK(!SIM7600HTTPS::defaultSendPolicy(metrics(20, true, SIM7600_BULK_MIN_RSRP - 1), SIM7600_TRANSFER_BULK, 0));
+  CHECK(SIM7600HTTPS::defaultSendPolicy(metrics(20, true, SIM7600_BULK_MIN_RSRP), SIM7600_TRANSFER_BULK, 0));
+  CHECK(SIM7600HTTPS::defaultSendPolicy(metrics(20, false, -120), SIM7600_TRANSFER_BULK, 0)); // No RSRP off LTE
+
+  // Large normal transfers are judged as bulk
+  CHECK(SIM7600HTTPS::defaultSendPolicy(metrics(12, false, 0), SIM7600_TRANSFER_NORMAL, SIM7600_BULK_BYTES - 1));
+  CHECK(!SIM7600HTTPS::defaultSendPolicy(metrics(12, false, 0), SIM7600_TRANSFER_NORMAL, SIM7600_BULK_BYTES));
+}
+
+// Signal trace, repeating every 30 minutes: 18 min good, 6 min marginal, 6 min in a fade where
+// the server's answer never arrives
+static int quality(unsigned long minute)
+{
+  unsigned long phase = minute % 30;
+  return (phase < 18) ? 2 : (phase < 24) ? 1 : 0;
+}
+
+struct TraceResult {
+  int delivered = 0;
+  int timeouts = 0;
+  int backlog = 0;
+  unsigned long busyMs = 0;   // Time spent in requests
+  unsigned long wastedMs = 0; // ... of which in requests that failed
+};
+
+// One record per minute for two hours; the queue is flushed while requests succeed
+static TraceResult runTrace(bool gated)
+{
+  FakeModem modem;
+  unsigned long t0 = millis();
+  modem.hook = [t0](const std::string& cmd, FakeModem& m) {
+    int q = quality((millis() - t0) / 60000);
+    csq = (q == 2) ? 20 : (q == 1) ? 12 : 6;
+    cpsi = "+CPSI: LTE,Online,460-11,0x5A1E,187214081,257,EUTRAN-BAND3,1825,5,5,-110," +
+           std::string((q == 2) ? "-900" : (q == 1) ? "-1080" : "-1190") + ",-600,5";
+    if (radioModem(cmd, m))
+      return true;
+    if (cmd.compare(0, 14, "AT+HTTPACTION=") == 0)
+    {
+      m.actionMs = (q == 2) ? 800 : 3000;
+      if (q == 0)
+      {
+        m.q("\r\nOK\r\n"); // Lost in the fade
+        return true;
+      }
+    }
+    return false;
+  };
+  modem.body = "{\"ack\":1}";
+  SIM7600HTTPS http(modem);
+  String body = "{\"temp\":21.5,\"hum\":40,\"volt\":12.61,\"energy_wh\":100231}";
+  String response;
+
+  TraceResult r;
+  for (unsigned long minute = 0; minute < 120; minute++)
+  {
+    unsigned long due = t0 + minute * 60000;
+    if ((long)(due - millis()) > 0)
+      mockAdvance(due - millis());
+    r.backlog++;
+    while (r.backlog > 0 && millis() - due < 60000)
+    {
+      if (gated && !http.linkAllows(SIM7600_TRANSFER_NORMAL))
+        break; // Hold the backlog until the link recovers
+      unsigned long start = millis();
+      bool ok = http.httpInit("https://example.com", "/telemetry", SIM7600_HTTP_POST) &&
+                http.httpPost(body.c_str(), response);
+      r.busyMs += millis() - start;
+      if (!ok)
+      {
+        r.timeouts++;
+        r.wastedMs += millis() - start;
+        break; // Try again next minute
+      }
+      r.delivered++;
+      r.backlog--;
+    }
+  }
+  return r;
+}
+
+static void testTrace()
+{
+  TraceResult always = runTrace(false);
+  TraceResult gated = runTrace(true);
+  for (int i = 0; i < 2; i++)
+  {
+    const TraceResult& r = i ? gated : always;
+    printf("%-8s delivered %3d, timeouts %2d, backlog %d, busy %5.1f s (%5.1f s wasted), goodput %.2f records/s busy\n",
+           i ? "gated" : "always", r.delivered, r.timeouts, r.backlog, r.busyMs / 1000.0, r.wastedMs / 1000.0,
+           r.delivered * 1000.0 / r.busyMs);
+  }
+  CHECK(always.timeouts > 0);
+  CHECK(gated.timeouts < always.timeouts / 4);
+  CHECK(gated.wastedMs < always.wastedMs);
+  CHECK(gated.delivered >= always.delivered - 6); // Both hold the last fade's records at the end
+  CHECK(gated.delivered * 1000.0 / gated.busyMs > always.delivered * 1000.0 / always.busyMs);
+}
+
+int main()
+{
+  testParse();
+  testPolicy();
+  testTrace();
+  return TEST_RESULT();
+}
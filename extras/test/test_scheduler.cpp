@@ -0,0 +1,163 @@
+// Scheduler timing: anchored periods, merging, stale drops, priority order, gate, next-release query
+#include "SIM7600Test.h"
+#include "SIM7600Scheduler.h"
+
+static unsigned long runTimes[64];
+static int runCount = 0;
+static unsigned long workMs = 0;
+static char order[16];
+static int orderLen = 0;
+
+static bool timedJob(void*)
+{
+  if (runCount < 64)
+    runTimes[runCount] = millis();
+  runCount++;
+  mockAdvance((runCount % 5 == 0) ? 7000 : workMs); // Every 5th run overruns 3 periods
+  return true;
+}
+
+static bool plainJob(void* ctx)
+{
+  if (orderLen < 15)
+    order[orderLen++] = *(const char*)ctx;
+  mockAdvance(workMs);
+  return true;
+}
+
+static bool blockJob(void*)
+{
+  mockAdvance(1500);
+  return true;
+}
+
+static bool gateOpen = false;
+static bool gate(void*, uint8_t) { return gateOpen; }
+
+// Run until `endMs`, jumping idle time like the sketch's loop() would
+static void runUntil(SIM7600Scheduler& s, unsigned long endMs)
+{
+  while (millis() < endMs)
+  {
+    if (!s.run())
+    {
+      unsigned long wait = s.msUntilNextJob();
+      mockAdvance((wait == 0 || wait > endMs - millis()) ? 1 : wait);
+    }
+  }
+}
+
+static void testAnchoredPeriod()
+{
+  mockSetMicros(0);
+  runCount = 0;
+  workMs = 100;
+  SIM7600Scheduler s;
+  int id = s.addPeriodic(timedJob, nullptr, 2000, 1);
+  runUntil(s, 40000);
+
+  const SIM7600JobStats& st = s.stats(id);
+  CHECK(st.merged > 0);              // Overruns fold missed releases
+  CHECK(st.runs + st.merged == 19);  // Releases 0..36000 ran or were merged; 38000 is still pending
+  bool onGrid = true;
+  for (int i = 0; i < runCount && i < 64; i++)
+  {
+    bool afterOverrun = (i % 5 == 0) && i > 0; // Merged release runs as soon as the modem is free
+    if (!afterOverrun && runTimes[i] % 2000 != 0)
+      onGrid = false; // Later releases stay on the period grid (no drift)
+  }
+  CHECK(onGrid);
+}
+
+static void testDropStale()
+{
+  mockSetMicros(0);
+  workMs = 10;
+  SIM7600Scheduler s;
+  static const char tag = 'g';
+  int fast = s.addPeriodic(plainJob, (void*)&tag, 1000, 1, 200, 0, SIM7600_JOB_DROP_STALE);
+  s.addOneShot(blockJob, nullptr, 1100, 5); // Holds the modem across the fast job's deadline
+  runUntil(s, 5000);
+
+  const SIM7600JobStats& st = s.stats(fast);
+  CHECK(st.dropped == 1);
+  CHECK(st.deadlineMisses == 1);
+  CHECK(st.maxLatenessMs == 0); // The stale instance was skipped, not run late
+}
+
+static void testPriorityOrder()
+{
+  mockSetMicros(0);
+  workMs = 10;
+  orderLen = 0;
+  SIM7600Scheduler s;
+  static const char low = 'l', high = 'h', urgent = 'u', later = 'd';
+  s.addOneShot(plainJob, (void*)&low, 0, 1);
+  s.addOneShot(plainJob, (void*)&later, 0, 2, 5000);
+  s.addOneShot(plainJob, (void*)&urgent, 0, 2, 1000);
+  s.addOneShot(plainJob, (void*)&high, 0, 3);
+  runUntil(s, 100);
+  order[orderLen] = 0;
+  CHECK(strcmp(order, "hudl") == 0); // Priority first, then earliest deadline
+}
+
+static void testGateAndFloor()
+{
+  mockSetMicros(0);
+  workMs = 10;
+  orderLen = 0;
+  SIM7600Scheduler s;
+  static const char bulk = 'b';
+  s.setGate(gate, nullptr);
+  int id = s.addPeriodic(plainJob, (void*)&bulk, 1000, 1, 0, 0, SIM7600_JOB_BULK);
+
+  gateOpen = false;
+  runUntil(s, 3500);
+  CHECK(s.stats(id).runs == 0);
+  CHECK(s.stats(id).deferred == s.stats(id).merged + 1); // Once per held release, not per run() call
+
+  gateOpen = true;
+  runUntil(s, 3600);
+  CHECK(s.stats(id).runs == 1); // Held releases merge into one run
+
+  s.setPriorityFloor(2);
+  unsigned long before = s.stats(id).runs;
+  runUntil(s, 8000);
+  CHECK(s.stats(id).runs == before);
+}
+
+static void testNextRelease()
+{
+  mockSetMicros(0);
+  workMs = 10;
+  SIM7600Scheduler s;
+  static const char tag = 'n';
+  s.addOneShot(plainJob, (void*)&tag, 5000, 1, 800);
+  s.addOneShot(plainJob, (void*)&tag, 9000, 1);
+  unsigned long slack = 0;
+  CHECK(s.msUntilNextJob(&slack) == 5000);
+  CHECK(slack == 800);
+  mockAdvance(5000);
+  CHECK(s.msUntilNextJob() == 0);
+  CHECK(s.run());
+  CHECK(s.msUntilNextJob() == 3990);
+
+  // Wraparound of millis(): releases just past the wrap are still ordered correctly
+  mockSetMicros((uint64_t)(0xFFFFFFFFUL - 500) * 1000);
+  SIM7600Scheduler w;
+  w.addOneShot(plainJob, (void*)&tag, 1000, 1);
+  CHECK(w.msUntilNextJob() == 1000);
+  CHECK(!w.run());
+  mockAdvance(1000);
+  CHECK(w.run());
+}
+
+int main()
+{
+  testAnchoredPeriod();
+  testDropStale();
+  testPriorityOrder();
+  testGateAndFloor();
+  testNextRelease();
+  return TEST_RESULT();
+}
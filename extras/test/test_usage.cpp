@@ -0,0 +1,128 @@
+// Data balance (USSD) and per-endpoint usage accounting
+#include "SIM7600Test.h"
+#include "FakeModem.h"
+#include "SIM7600HTTPS.h"
+
+static void testParse()
+{
+  CHECK(SIM7600HTTPS::parseDataBalance("Data balance: 1,024 MB") == 1024L * 1024);
+  CHECK(SIM7600HTTPS::parseDataBalance("Bal 12,345,678 KB valid 30 days") == 12345678L);
+  CHECK(SIM7600HTTPS::parseDataBalance("You have 1.5GB left") == 1536L * 1024);
+  CHECK(SIM7600HTTPS::parseDataBalance("Restant: 1,5 Go / 1,5 GB") == 1536L * 1024); // Decimal comma
+  CHECK(SIM7600HTTPS::parseDataBalance("500KB") == 500);
+  CHECK(SIM7600HTTPS::parseDataBalance("Airtime 250 Ksh, bundle 2 GB") == 2L * 1024 * 1024);
+  CHECK(SIM7600HTTPS::parseDataBalance("Dial *544# for offers, 100, 200") == -1);
+}
+
+// Answer AT+CUSD with the given pieces, each arriving 1 s after the previous one
+static std::vector<std::string> pieces;
+
+static bool ussd(const std::string& cmd, FakeModem& m)
+{
+  if (cmd.compare(0, 10, "AT+CUSD=1,") != 0)
+    return false;
+  m.q("\r\nOK\r\n");
+  for (size_t i = 0; i < pieces.size(); i++)
+    m.later(1000 * (i + 1), pieces[i]);
+  return true;
+}
+
+static void testMultiLine()
+{
+  FakeModem modem;
+  modem.hook = ussd;
+  SIM7600HTTPS http(modem);
+  pieces.clear();
+  pieces.push_back("\r\n+CUSD: 0,\"Data: 1,024 MB\r\n");
+  pieces.push_back("Valid till 31/12\r\nDial *100# for more\",15\r\n");
+
+  CHECK(http.beginDataBalanceQuery("*544#"));
+  CHECK(!http.beginDataBalanceQuery("*544#")); // One at a time
+  int polls = 0;
+  int state;
+  while ((state = http.pollDataBalance()) == SIM7600_PENDING)
+  {
+    polls++;
+    mockAdvance(100);
+  }
+  CHECK(state == SIM7600_DONE);
+  CHECK(polls >= 15); // Not finished after the first line
+  CHECK(http.dataBalanceReply() == "Data: 1,024 MB\r\nValid till 31/12\r\nDial *100# for more");
+  CHECK(http.dataBalanceKB() == 1024L * 1024);
+}
+
+static void testMenu()
+{
+  FakeModem modem;
+  modem.hook = ussd;
+  SIM7600HTTPS http(modem);
+  pieces.clear();
+  pieces.push_back("\r\n+CUSD: 1,\"1. Balance\r\n2. Buy bundle\r\n");
+  pieces.push_back("3. Exit\",15\r\n");
+  String reply = http.checkDataBalance("*100#");
+  CHECK(reply == "1. Balance\r\n2. Buy bundle\r\n3. Exit");
+  CHECK(http.dataBalanceKB() == -1);
+  CHECK(modem.log.back() == "AT+CUSD=2"); // Menu session closed
+}
+
+static void testNoReply()
+{
+  FakeModem modem;
+  modem.hook = ussd;
+  SIM7600HTTPS http(modem);
+
+  pieces.clear();
+  pieces.push_back("\r\n+CUSD: 4\r\n"); // Not supported: no text
+  CHECK(http.checkDataBalance("*544#") == "");
+
+  pieces.clear();
+  pieces.push_back("\r\n+CUSD: 0,\"Data: 2 GB\r\nnever closed");
+  unsigned long start = millis();
+  CHECK(http.checkDataBalance("*544#") == "");
+  CHECK(millis() - start >= 20000);
+  CHECK(http.dataBalanceKB() == -1);
+}
+
+static void testUsage()
+{
+  FakeModem modem;
+  modem.body = std::string(100, 'x');
+  SIM7600HTTPS http(modem);
+  String response;
+  char paths[SIM7600_MAX_ENDPOINTS + 2][8];
+  for (int i = 0; i < SIM7600_MAX_ENDPOINTS + 2; i++)
+  {
+    snprintf(paths[i], sizeof(paths[i]), "/r%d", i);
+    CHECK(http.httpInit("http://example.com", paths[i]) && http.httpGet(response));
+  }
+  CHECK(http.httpInit("http://example.com", paths[0]) && http.httpGet(response));
+
+  const SIM7600EndpointUsage* first = http.endpointUsage(paths[0]);
+  CHECK(first != nullptr && first->requests == 2 && first->rxBytes == 200 && first->txBytes == 0);
+  CHECK(first != nullptr && first->overheadBytes == 2 * (SIM7600_EST_REQUEST_HEADERS + 3 + SIM7600_EST_RESPONSE_HEADERS));
+  CHECK(http.endpointUsage(paths[SIM7600_MAX_ENDPOINTS - 2]) != nullptr);
+  CHECK(http.endpointUsage(paths[SIM7600_MAX_ENDPOINTS - 1]) == nullptr); // Counted under "other"
+  const SIM7600EndpointUsage* other = http.endpointUsage(SIM7600_OTHER_ENDPOINTS);
+  CHECK(other != nullptr && other->requests == 3 && other->rxBytes == 300);
+
+  unsigned long perRequest = 100 + SIM7600_EST_REQUEST_HEADERS + 3 + SIM7600_EST_RESPONSE_HEADERS;
+  CHECK(http.totalDataUsage() == (SIM7600_MAX_ENDPOINTS + 3) * perRequest);
+  http.resetDataUsage();
+  CHECK(http.totalDataUsage() == 0 && http.endpointUsage(paths[0]) == nullptr);
+
+  // TLS adds a handshake and record framing
+  CHECK(http.httpInit("https://example.com", "/tls") && http.httpGet(response));
+  const SIM7600EndpointUsage* tls = http.endpointUsage("/tls");
+  CHECK(tls != nullptr && tls->overheadBytes == SIM7600_EST_REQUEST_HEADERS + 4 + SIM7600_EST_RESPONSE_HEADERS +
+                                                    SIM7600_EST_TLS_HANDSHAKE + 2 * SIM7600_EST_TLS_RECORD);
+}
+
+int main()
+{
+  testParse();
+  testMultiLine();
+  testMenu();
+  testNoReply();
+  testUsage();
+  return TEST_RESULT();
+}